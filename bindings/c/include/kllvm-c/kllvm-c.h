@@ -131,6 +131,53 @@ void kore_simplify_binary(
 
 block *take_steps(int64_t depth, block *term);
 
+/*
+ * Direct Term Construction
+ * ========================
+ *
+ * These functions build runtime terms on the K heap without going through an
+ * intermediate `kore_pattern`. A symbol is resolved to a tag once with
+ * `kore_symbol_tag`; each term with that symbol is then built by allocating a
+ * block with `kore_block_new`, storing each of its children with
+ * `kore_block_set_child`, and passing the block to `kore_block_finish`.
+ *
+ * Only constructor symbols can be built this way; terms headed by function
+ * symbols should be built with `kore_pattern_construct`.
+ *
+ * Children are passed in the form returned by these functions: a `block *`
+ * for children of user-defined sorts, and the pointer returned by
+ * `kore_token_new` for tokens of hooked sorts such as `SortInt` or `SortBool`.
+ */
+
+/*
+ * Return the tag of the symbol with the given name, written in KORE syntax
+ * (e.g. `Lblfoo{}`).
+ */
+uint32_t kore_symbol_tag(kore_error *, char const *);
+
+uint32_t kore_symbol_arity(uint32_t);
+
+/*
+ * Allocate an uninitialized term for the constructor with the given tag. If
+ * the constructor has no arguments, the returned term is already complete.
+ */
+block *kore_block_new(uint32_t);
+
+void kore_block_set_child(block *, uint32_t, void *);
+
+/*
+ * Return the complete term for a block whose children have all been set. The
+ * result may differ from the argument: injections of injections are collapsed,
+ * and binders are converted to their internal representation.
+ */
+block *kore_block_finish(block *);
+
+/*
+ * Parse a token of the given sort (e.g. `SortInt`) from the given string of the
+ * given length.
+ */
+void *kore_token_new(char const *, char const *, size_t);
+
 /* kore_sort */
 
 char *kore_sort_dump(kore_sort const *);
@@ -332,6 +332,71 @@ void kore_simplify_binary(
   }
 }
 
+/* Direct term construction */
+
+uint32_t kore_symbol_tag(kore_error *err, char const *name) {
+  try {
+    return get_tag_for_symbol_name(name);
+  } catch (std::exception &e) {
+    if (err == nullptr) {
+      throw;
+    }
+
+    err->set_error(e.what());
+    return ERROR_TAG;
+  }
+}
+
+uint32_t kore_symbol_arity(uint32_t tag) {
+  return get_symbol_arity(tag);
+}
+
+block *kore_block_new(uint32_t tag) {
+  if (get_symbol_arity(tag) == 0) {
+    return leaf_block(tag);
+  }
+
+  auto header = get_block_header_for_symbol(tag);
+  auto *term = static_cast<block *>(kore_alloc(size_hdr(header.hdr)));
+  term->h = header;
+  return term;
+}
+
+void kore_block_set_child(block *term, uint32_t idx, void *child) {
+  auto const &item = get_layout_data(get_layout(term))->args[idx];
+  auto *slot = reinterpret_cast<char *>(term) + item.offset;
+
+  switch (item.cat) {
+  case MAP_LAYOUT: new (slot) map(*static_cast<map *>(child)); break;
+  case RANGEMAP_LAYOUT:
+    new (slot) rangemap(*static_cast<rangemap *>(child));
+    break;
+  case LIST_LAYOUT: new (slot) list(*static_cast<list *>(child)); break;
+  case SET_LAYOUT: new (slot) set(*static_cast<set *>(child)); break;
+  case BOOL_LAYOUT: std::memcpy(slot, child, sizeof(bool)); break;
+  case INT_LAYOUT:
+  case FLOAT_LAYOUT:
+  case STRINGBUFFER_LAYOUT:
+  case SYMBOL_LAYOUT:
+  case VARIABLE_LAYOUT: std::memcpy(slot, &child, sizeof(child)); break;
+  default: {
+    // MInt children are stored inline; their category is the category that
+    // follows MAPITER_LAYOUT plus their width in bits.
+    auto bits = item.cat - MAPITER_LAYOUT - 1;
+    std::memcpy(slot, child, (bits + 7) / 8);
+    break;
+  }
+  }
+}
+
+block *kore_block_finish(block *term) {
+  return finish_composite_block(term);
+}
+
+void *kore_token_new(char const *sort, char const *value, size_t len) {
+  return get_token(sort, len, value);
+}
+
 /* kore_composite_pattern */
 
 kore_pattern *kore_composite_pattern_new(char const *name) {
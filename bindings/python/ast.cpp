@@ -383,9 +383,51 @@ void bind_parser(py::module_ &mod) {
       .def("symbol", &kore_parser::symbol);
 }
 
+class py_llvm_rewrite_trace_visitor : public llvm_rewrite_trace_visitor {
+public:
+  void version(uint32_t version) override {
+    PYBIND11_OVERRIDE(void, llvm_rewrite_trace_visitor, version, version);
+  }
+  void config(llvm_event_type type, llvm_kore_term const &config) override {
+    PYBIND11_OVERRIDE(void, llvm_rewrite_trace_visitor, config, type, config);
+  }
+  void rule(llvm_event_type type, llvm_rule_event const &event) override {
+    PYBIND11_OVERRIDE(void, llvm_rewrite_trace_visitor, rule, type, event);
+  }
+  void elided_rule(
+      llvm_event_type type, llvm_elided_rule_event const &event) override {
+    PYBIND11_OVERRIDE(
+        void, llvm_rewrite_trace_visitor, elided_rule, type, event);
+  }
+  void side_condition(
+      llvm_event_type type, llvm_side_condition_event const &event) override {
+    PYBIND11_OVERRIDE(
+        void, llvm_rewrite_trace_visitor, side_condition, type, event);
+  }
+  void side_condition_end(
+      llvm_event_type type,
+      llvm_side_condition_end_event const &event) override {
+    PYBIND11_OVERRIDE(
+        void, llvm_rewrite_trace_visitor, side_condition_end, type, event);
+  }
+  void
+  function(llvm_event_type type, llvm_function_event const &event) override {
+    PYBIND11_OVERRIDE(void, llvm_rewrite_trace_visitor, function, type, event);
+  }
+  void hook(llvm_event_type type, llvm_hook_event const &event) override {
+    PYBIND11_OVERRIDE(void, llvm_rewrite_trace_visitor, hook, type, event);
+  }
+};
+
 void bind_proof_trace(py::module_ &m) {
   auto proof_trace = m.def_submodule("prooftrace", "K LLVM backend KORE AST");
 
+  py::class_<llvm_kore_term>(proof_trace, "kore_term")
+      .def_property_readonly("pattern", &llvm_kore_term::get_pattern)
+      .def_property_readonly(
+          "pattern_length", &llvm_kore_term::get_pattern_length)
+      .def_property_readonly("is_decoded", &llvm_kore_term::is_decoded);
+
   auto step_event
       = py::class_<llvm_step_event, std::shared_ptr<llvm_step_event>>(
             proof_trace, "llvm_step_event")
@@ -397,12 +439,20 @@ void bind_proof_trace(py::module_ &m) {
             .def_property_readonly(
                 "rule_ordinal", &llvm_rewrite_event::get_rule_ordinal)
             .def_property_readonly(
-                "substitution", &llvm_rewrite_event::get_substitution);
+                "substitution", &llvm_rewrite_event::get_substitution)
+            .def_property_readonly(
+                "substitution_terms",
+                &llvm_rewrite_event::get_substitution_terms);
 
   [[maybe_unused]] auto rule_event
       = py::class_<llvm_rule_event, std::shared_ptr<llvm_rule_event>>(
           proof_trace, "llvm_rule_event", rewrite_event);
 
+  py::class_<llvm_elided_rule_event, std::shared_ptr<llvm_elided_rule_event>>(
+      proof_trace, "llvm_elided_rule_event", step_event)
+      .def_property_readonly(
+          "rule_ordinal", &llvm_elided_rule_event::get_rule_ordinal);
+
   [[maybe_unused]] auto side_condition_event = py::class_<
       llvm_side_condition_event, std::shared_ptr<llvm_side_condition_event>>(
       proof_trace, "llvm_side_condition_event", rewrite_event);
@@ -430,12 +480,14 @@ void bind_proof_trace(py::module_ &m) {
       .def_property_readonly(
           "relative_position", &llvm_hook_event::get_relative_position)
       .def_property_readonly("args", &llvm_hook_event::get_arguments)
-      .def_property_readonly("result", &llvm_hook_event::getkore_pattern);
+      .def_property_readonly("result", &llvm_hook_event::getkore_pattern)
+      .def_property_readonly("result_term", &llvm_hook_event::get_result);
 
   py::class_<llvm_event, std::shared_ptr<llvm_event>>(proof_trace, "Argument")
       .def("__repr__", print_repr_adapter<llvm_event>(true, true))
       .def_property_readonly("step_event", &llvm_event::get_step_event)
       .def_property_readonly("kore_pattern", &llvm_event::getkore_pattern)
+      .def_property_readonly("kore_term", &llvm_event::get_kore_term)
       .def("is_step_event", &llvm_event::is_step)
       .def("is_kore_pattern", &llvm_event::is_pattern);
 
@@ -449,12 +501,13 @@ void bind_proof_trace(py::module_ &m) {
       .def_property_readonly("trace", &llvm_rewrite_trace::get_trace)
       .def_static(
           "parse",
-          [](py::bytes const &bytes, kore_header const &header) {
-            proof_trace_parser parser(false, false, header);
+          [](py::bytes const &bytes, kore_header const &header, bool lazy) {
+            proof_trace_parser parser(false, false, header, lazy);
             auto str = std::string(bytes);
             return parser.parse_proof_trace(str);
           },
-          py::arg("bytes"), py::arg("header"));
+          py::arg("bytes"), py::arg("header"), py::arg("lazy") = false,
+          py::keep_alive<0, 2>());
 
   py::class_<kore_header, std::shared_ptr<kore_header>>(
       proof_trace, "kore_header")
@@ -476,16 +529,33 @@ void bind_proof_trace(py::module_ &m) {
       .def("__repr__", print_repr_adapter<llvm_rewrite_trace_iterator>(true))
       .def_static(
           "from_file",
-          [](std::string const &filename, kore_header const &header) {
+          [](std::string const &filename, kore_header const &header,
+             bool lazy) {
             std::ifstream file(filename, std::ios_base::binary);
             return llvm_rewrite_trace_iterator(
                 std::make_unique<proof_trace_file_buffer>(std::move(file)),
-                header);
+                header, lazy);
           },
-          py::arg("filename"), py::arg("header"))
+          py::arg("filename"), py::arg("header"), py::arg("lazy") = false,
+          py::keep_alive<0, 2>())
       .def_property_readonly(
           "version", &llvm_rewrite_trace_iterator::get_version)
-      .def("get_next_event", &llvm_rewrite_trace_iterator::get_next_event);
+      .def("get_next_event", &llvm_rewrite_trace_iterator::get_next_event)
+      .def("visit", &llvm_rewrite_trace_iterator::visit, py::arg("visitor"));
+
+  py::class_<llvm_rewrite_trace_visitor, py_llvm_rewrite_trace_visitor>(
+      proof_trace, "llvm_rewrite_trace_visitor")
+      .def(py::init<>())
+      .def("version", &llvm_rewrite_trace_visitor::version)
+      .def("config", &llvm_rewrite_trace_visitor::config)
+      .def("rule", &llvm_rewrite_trace_visitor::rule)
+      .def("elided_rule", &llvm_rewrite_trace_visitor::elided_rule)
+      .def("side_condition", &llvm_rewrite_trace_visitor::side_condition)
+      .def(
+          "side_condition_end",
+          &llvm_rewrite_trace_visitor::side_condition_end)
+      .def("function", &llvm_rewrite_trace_visitor::function)
+      .def("hook", &llvm_rewrite_trace_visitor::hook);
 }
 
 PYBIND11_MODULE(_kllvm, m) {
@@ -32,6 +32,11 @@ def make_term_class(mod):
         def serialize(self, emit_size=False):
             return self._block.serialize(emit_size=emit_size)
 
+        # Serializes into the bytearray out, resizing it to fit, and returns
+        # the number of bytes written.
+        def serialize_into(self, out, emit_size=False):
+            return self._block.serialize_into(out, emit_size=emit_size)
+
         # Used to implement backend integration tests; should not be bound
         # onwards to Pyk without rethinking the underlying API.
         def _serialize_raw(self, filename, sort):
@@ -46,6 +46,75 @@ block *take_steps(int64_t, block *);
 void *construct_initial_configuration(kore_pattern const *initial);
 }
 
+namespace {
+
+/*
+ * A read-only view of the contiguous buffer exported by a Python object (bytes,
+ * bytearray, memoryview, mmap, ...), so that it can be read without copying.
+ */
+class contiguous_buffer {
+public:
+  explicit contiguous_buffer(py::handle obj) {
+    if (PyObject_GetBuffer(obj.ptr(), &view_, PyBUF_SIMPLE) != 0) {
+      throw py::error_already_set();
+    }
+  }
+
+  contiguous_buffer(contiguous_buffer const &) = delete;
+  contiguous_buffer &operator=(contiguous_buffer const &) = delete;
+
+  ~contiguous_buffer() { PyBuffer_Release(&view_); }
+
+  char *data() { return static_cast<char *>(view_.buf); }
+  size_t size() const { return view_.len; }
+
+private:
+  Py_buffer view_{};
+};
+
+/*
+ * Both of these serialize a term straight into memory owned by a Python object,
+ * rather than copying the serialized bytes out of an intermediate buffer.
+ */
+py::bytes serialize_to_bytes(block *term, bool emit_size) {
+  py::object result;
+  serialize_configuration_with_allocator(
+      term, nullptr, emit_size, true,
+      [](size_t size, void *context) -> char * {
+        auto &result = *static_cast<py::object *>(context);
+        result = py::reinterpret_steal<py::object>(
+            PyBytes_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size)));
+        return result ? PyBytes_AS_STRING(result.ptr()) : nullptr;
+      },
+      &result);
+
+  if (!result) {
+    throw py::error_already_set();
+  }
+  return py::reinterpret_steal<py::bytes>(result.release());
+}
+
+size_t serialize_to_bytearray(
+    block *term, py::bytearray const &out, bool emit_size) {
+  auto size = serialize_configuration_with_allocator(
+      term, nullptr, emit_size, true,
+      [](size_t size, void *context) -> char * {
+        auto *array = static_cast<PyObject *>(context);
+        if (PyByteArray_Resize(array, static_cast<Py_ssize_t>(size)) != 0) {
+          return nullptr;
+        }
+        return PyByteArray_AS_STRING(array);
+      },
+      out.ptr());
+
+  if (PyErr_Occurred()) {
+    throw py::error_already_set();
+  }
+  return size;
+}
+
+} // namespace
+
 void bind_runtime(py::module_ &m) {
   auto runtime = m.def_submodule("runtime", "K LLVM backend runtime");
 
@@ -79,20 +148,16 @@ void bind_runtime(py::module_ &m) {
       .def("step", [](block *term, int64_t n) { return take_steps(n, term); })
       .def("to_pattern", [](block *term) { return term_to_kore_pattern(term); })
       .def(
-          "serialize",
-          [](block *term, bool emit_size) {
-            char *data = nullptr;
-            size_t size = 0;
-            serialize_configuration(
-                term, nullptr, &data, &size, emit_size, true);
-            return py::bytes(std::string(data, data + size));
-          },
+          "serialize", serialize_to_bytes, py::kw_only(),
+          py::arg("emit_size") = false)
+      .def(
+          "serialize_into", serialize_to_bytearray, py::arg("out"),
           py::kw_only(), py::arg("emit_size") = false)
       .def(
           "deserialize",
-          [](py::bytes const &bytes) {
-            auto str = std::string(bytes);
-            return deserialize_configuration(str.data(), str.size());
+          [](py::object const &data) {
+            auto buffer = contiguous_buffer(data);
+            return deserialize_configuration(buffer.data(), buffer.size());
           })
       .def(
           "_serialize_raw", [](block *term, std::string const &filename,
@@ -38,7 +38,12 @@ set(RANGEMAP_LAYOUT    10)
 set(SETITER_LAYOUT     11)
 set(MAPITER_LAYOUT     12)
 
+# Layout id reserved for rope nodes produced by String concatenation. Layout ids
+# of symbols are allocated upwards from 1 and must stay below this value.
+set(ROPE_LAYOUT        1023)
+
 get_filename_component(INSTALL_DIR_ABS_PATH "${CMAKE_INSTALL_PREFIX}"
                        REALPATH BASE_DIR "${CMAKE_BINARY_DIR}")
 
 set(ERROR_TAG 4294967294) # 2^32-2
+set(ROPE_TAG  4294967293) # 2^32-3
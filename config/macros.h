@@ -27,6 +27,7 @@
 #define RANGEMAP_LAYOUT @RANGEMAP_LAYOUT@
 #define SETITER_LAYOUT @SETITER_LAYOUT@
 #define MAPITER_LAYOUT @MAPITER_LAYOUT@
+#define ROPE_LAYOUT @ROPE_LAYOUT@
 
 #define STRINGIFY(x) #x
 #define TOSTRING(X) STRINGIFY(X)
@@ -35,6 +36,7 @@
 #define GDB_SCRIPT_NAME TOSTRING(@GDB_SCRIPT_NAME@)
 
 #define ERROR_TAG @ERROR_TAG@
+#define ROPE_TAG @ROPE_TAG@
 
 #define BACKEND_TARGET_DATALAYOUT TOSTRING(@BACKEND_TARGET_DATALAYOUT@)
 #define BACKEND_TARGET_TRIPLE TOSTRING(@BACKEND_TARGET_TRIPLE@)
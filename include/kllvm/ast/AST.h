@@ -346,6 +346,11 @@ using SymbolMap = std::unordered_map<
     kore_symbol *, SymbolSet, hash_symbol_ptr, equal_symbol_ptr>;
 using BracketMap = std::unordered_map<
     kore_sort *, std::vector<kore_symbol *>, hash_sort_ptr, equal_sort_ptr>;
+// map from the name of the head symbol of a macro's left-hand side to the
+// indices of the macros that can apply to a pattern with that head symbol
+using MacroIndex = std::unordered_map<std::string, std::vector<size_t>>;
+
+struct sort_key_cache;
 
 struct pretty_print_data {
   // map from symbol name to format attribute specifying how to print that
@@ -369,6 +374,8 @@ struct pretty_print_data {
   SubsortMap subsorts;
   // enable coloring
   bool has_color{};
+  // sort keys of collection elements, set while sort_collections computes them
+  sort_key_cache *sort_keys{};
 };
 
 class kore_declaration;
@@ -450,8 +457,7 @@ private:
   virtual sptr<kore_pattern> expand_macros(
       SubsortMap const &subsorts, SymbolMap const &overloads,
       std::vector<ptr<kore_declaration>> const &axioms, bool reverse,
-      std::set<size_t> &applied_rules,
-      std::set<std::string> const &macro_symbols)
+      std::set<size_t> &applied_rules, MacroIndex const &macro_index)
       = 0;
 };
 
@@ -524,8 +530,7 @@ private:
   sptr<kore_pattern> expand_macros(
       SubsortMap const &, SymbolMap const &,
       std::vector<ptr<kore_declaration>> const &macros, bool reverse,
-      std::set<size_t> &applied_rules,
-      std::set<std::string> const &macro_symbols) override {
+      std::set<size_t> &applied_rules, MacroIndex const &macro_index) override {
     return shared_from_this();
   }
 
@@ -604,8 +609,7 @@ private:
   sptr<kore_pattern> expand_macros(
       SubsortMap const &, SymbolMap const &,
       std::vector<ptr<kore_declaration>> const &macros, bool reverse,
-      std::set<size_t> &applied_rules,
-      std::set<std::string> const &macro_symbols) override;
+      std::set<size_t> &applied_rules, MacroIndex const &macro_index) override;
 
   friend void ::kllvm::deallocate_s_ptr_kore_pattern(
       sptr<kore_pattern> pattern);
@@ -671,8 +675,7 @@ private:
   sptr<kore_pattern> expand_macros(
       SubsortMap const &, SymbolMap const &,
       std::vector<ptr<kore_declaration>> const &macros, bool reverse,
-      std::set<size_t> &applied_rules,
-      std::set<std::string> const &macro_symbols) override {
+      std::set<size_t> &applied_rules, MacroIndex const &macro_index) override {
     return shared_from_this();
   }
 
@@ -793,6 +796,7 @@ private:
   sptr<kore_pattern> pattern_;
   unsigned ordinal_{};
   bool is_claim_;
+  std::string module_name_;
 
   kore_axiom_declaration(bool is_claim)
       : is_claim_(is_claim) { }
@@ -817,6 +821,11 @@ public:
   [[nodiscard]] kore_pattern *get_requires() const;
   [[nodiscard]] sptr<kore_pattern> get_pattern() const { return pattern_; }
   [[nodiscard]] unsigned get_ordinal() const { return ordinal_; }
+  /* the name of the module that declares the axiom; set when the module is
+     added to a definition. */
+  [[nodiscard]] std::string const &get_module_name() const {
+    return module_name_;
+  }
 
   friend kore_definition;
 };
@@ -926,6 +935,7 @@ private:
 
   std::optional<SubsortMap> subsorts_;
   std::optional<SubsortMap> supersorts_;
+  std::optional<std::unordered_set<std::string>> injection_functions_;
 
   /*
    * Insert symbols into this definition that have knowable labels, but cannot
@@ -998,6 +1008,17 @@ public:
    */
   [[nodiscard]] SymbolMap get_overloads() const;
 
+  /*
+   * Returns false if no call to the function symbol with the given name can
+   * evaluate to an injection inj{S1, S2}(t). This is the case when every rule
+   * for the function has a constructor, a domain value, a variable of a sort
+   * without subsorts, or a call to such a function as its right-hand side.
+   *
+   * Hooked functions, functions without rules and symbols that are not
+   * functions may return anything, and the result is true for them.
+   */
+  bool may_return_injection(std::string const &function_name);
+
   [[nodiscard]] std::vector<sptr<kore_module>> const &get_modules() const {
     return modules_;
   }
@@ -5,6 +5,8 @@
 #include <kllvm/binary/deserializer.h>
 
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -33,6 +35,41 @@ constexpr uint64_t hook_result_sentinel = detail::word(0xBB);
 constexpr uint64_t rule_event_sentinel = detail::word(0x22);
 constexpr uint64_t side_condition_event_sentinel = detail::word(0xEE);
 constexpr uint64_t side_condition_end_sentinel = detail::word(0x33);
+constexpr uint64_t rule_elided_sentinel = detail::word(0x44);
+
+// A KORE term recorded in a proof trace. When a trace is parsed lazily, only
+// the bytes of each term are kept, and they are decoded into a kore_pattern the
+// first time the pattern is requested; the kore_header used to parse the trace
+// must then outlive the term.
+class llvm_kore_term {
+private:
+  struct encoded_term {
+    std::string bytes;
+    kore_header const *header;
+    sptr<kore_pattern> pattern;
+  };
+
+  sptr<kore_pattern> pattern_{};
+  std::shared_ptr<encoded_term> encoded_{};
+  uint64_t pattern_length_{};
+
+public:
+  llvm_kore_term() = default;
+  llvm_kore_term(sptr<kore_pattern> pattern, uint64_t pattern_length)
+      : pattern_(std::move(pattern))
+      , pattern_length_(pattern_length) { }
+  llvm_kore_term(
+      std::string bytes, kore_header const &header, uint64_t pattern_length)
+      : encoded_(std::make_shared<encoded_term>(
+          encoded_term{std::move(bytes), &header, nullptr}))
+      , pattern_length_(pattern_length) { }
+
+  [[nodiscard]] sptr<kore_pattern> get_pattern() const;
+  [[nodiscard]] uint64_t get_pattern_length() const { return pattern_length_; }
+  [[nodiscard]] bool is_decoded() const {
+    return !encoded_ || encoded_->pattern;
+  }
+};
 
 class llvm_step_event : public std::enable_shared_from_this<llvm_step_event> {
 public:
@@ -46,10 +83,12 @@ class llvm_rewrite_event : public llvm_step_event {
 public:
   using substitution_t
       = std::map<std::string, std::pair<sptr<kore_pattern>, uint64_t>>;
+  using substitution_terms_t = std::map<std::string, llvm_kore_term>;
 
 private:
   uint64_t rule_ordinal_;
-  substitution_t substitution_{};
+  substitution_terms_t substitution_terms_{};
+  mutable std::optional<substitution_t> substitution_{};
 
 protected:
   void print_substitution(
@@ -60,15 +99,20 @@ public:
       : rule_ordinal_(rule_ordinal) { }
 
   [[nodiscard]] uint64_t get_rule_ordinal() const { return rule_ordinal_; }
-  [[nodiscard]] substitution_t const &get_substitution() const {
-    return substitution_;
+  // Decodes every term of the substitution if the trace was parsed lazily.
+  [[nodiscard]] substitution_t const &get_substitution() const;
+  [[nodiscard]] substitution_terms_t const &get_substitution_terms() const {
+    return substitution_terms_;
   }
 
   void add_substitution(
       std::string const &name, sptr<kore_pattern> const &term,
       uint64_t pattern_len) {
-    substitution_.insert(
-        std::make_pair(name, std::make_pair(term, pattern_len)));
+    add_substitution(name, llvm_kore_term(term, pattern_len));
+  }
+  void add_substitution(std::string const &name, llvm_kore_term const &term) {
+    substitution_terms_.insert(std::make_pair(name, term));
+    substitution_.reset();
   }
 
   ~llvm_rewrite_event() override = default;
@@ -88,6 +132,27 @@ public:
       const override;
 };
 
+// A rewrite step whose rule was excluded from instrumentation by a proof hint
+// filter; only the ordinal of the rule that applied is recorded.
+class llvm_elided_rule_event : public llvm_step_event {
+private:
+  uint64_t rule_ordinal_;
+
+  llvm_elided_rule_event(uint64_t rule_ordinal)
+      : rule_ordinal_(rule_ordinal) { }
+
+public:
+  static sptr<llvm_elided_rule_event> create(uint64_t rule_ordinal) {
+    return sptr<llvm_elided_rule_event>(
+        new llvm_elided_rule_event(rule_ordinal));
+  }
+
+  [[nodiscard]] uint64_t get_rule_ordinal() const { return rule_ordinal_; }
+
+  void print(std::ostream &out, bool expand_terms, unsigned indent = 0U)
+      const override;
+};
+
 class llvm_side_condition_event : public llvm_rewrite_event {
 private:
   llvm_side_condition_event(uint64_t rule_ordinal)
@@ -161,8 +226,7 @@ private:
   std::string symbol_name_;
   std::string relative_position_;
   std::vector<llvm_event> arguments_;
-  sptr<kore_pattern> kore_pattern_;
-  uint64_t pattern_length_{0U};
+  llvm_kore_term result_;
 
   llvm_hook_event(
       std::string name, std::string symbol_name, std::string relative_position);
@@ -186,14 +250,17 @@ public:
     return arguments_;
   }
   [[nodiscard]] sptr<kore_pattern> getkore_pattern() const {
-    return kore_pattern_;
+    return result_.get_pattern();
   }
-  [[nodiscard]] uint64_t get_pattern_length() const { return pattern_length_; }
+  [[nodiscard]] uint64_t get_pattern_length() const {
+    return result_.get_pattern_length();
+  }
+  [[nodiscard]] llvm_kore_term const &get_result() const { return result_; }
   void
   setkore_pattern(sptr<kore_pattern> kore_pattern, uint64_t pattern_length) {
-    kore_pattern_ = std::move(kore_pattern);
-    pattern_length_ = pattern_length;
+    result_ = llvm_kore_term(std::move(kore_pattern), pattern_length);
   }
+  void set_result(llvm_kore_term result) { result_ = std::move(result); }
 
   void add_argument(llvm_event const &argument);
 
@@ -205,8 +272,7 @@ class llvm_event {
 private:
   bool is_step_event_{};
   sptr<llvm_step_event> step_event_{};
-  sptr<kore_pattern> kore_pattern_{};
-  uint64_t pattern_length_{};
+  llvm_kore_term kore_term_{};
 
 public:
   [[nodiscard]] bool is_step() const { return is_step_event_; }
@@ -215,18 +281,25 @@ public:
     return step_event_;
   }
   [[nodiscard]] sptr<kore_pattern> getkore_pattern() const {
-    return kore_pattern_;
+    return kore_term_.get_pattern();
+  }
+  [[nodiscard]] uint64_t get_pattern_length() const {
+    return kore_term_.get_pattern_length();
+  }
+  [[nodiscard]] llvm_kore_term const &get_kore_term() const {
+    return kore_term_;
   }
-  [[nodiscard]] uint64_t get_pattern_length() const { return pattern_length_; }
   void set_step_event(sptr<llvm_step_event> step_event) {
     is_step_event_ = true;
     step_event_ = std::move(step_event);
   }
   void
   setkore_pattern(sptr<kore_pattern> kore_pattern, uint64_t pattern_length) {
+    set_kore_term(llvm_kore_term(std::move(kore_pattern), pattern_length));
+  }
+  void set_kore_term(llvm_kore_term kore_term) {
     is_step_event_ = false;
-    kore_pattern_ = std::move(kore_pattern);
-    pattern_length_ = pattern_length;
+    kore_term_ = std::move(kore_term);
   }
   void print(
       std::ostream &out, bool expand_terms, bool is_arg,
@@ -273,26 +346,33 @@ public:
 
 class proof_trace_parser {
 public:
-  static constexpr uint32_t expected_version = 11U;
+  static constexpr uint32_t expected_version = 12U;
 
 private:
   bool verbose_;
   bool expand_terms_;
   [[maybe_unused]] kore_header const &header_;
+  bool lazy_;
 
-  sptr<kore_pattern>
-  parse_kore_term(proof_trace_buffer &buffer, uint64_t &pattern_len) {
+  bool parse_kore_term(proof_trace_buffer &buffer, llvm_kore_term &term) {
     std::array<char, 4> magic{};
     if (!buffer.read(magic.data(), sizeof(magic))) {
-      return nullptr;
+      return false;
     }
     if (magic[0] != '\x7F' || magic[1] != 'K' || magic[2] != 'R'
         || magic[3] != '2') {
-      return nullptr;
+      return false;
+    }
+    uint64_t pattern_len = 0;
+    if (lazy_) {
+      std::string bytes;
+      detail::read_v2_bytes(buffer, header_, bytes, pattern_len);
+      term = llvm_kore_term(std::move(bytes), header_, pattern_len + 4);
+    } else {
+      auto result = detail::read_v2(buffer, header_, pattern_len);
+      term = llvm_kore_term(result, pattern_len + 4);
     }
-    auto result = detail::read_v2(buffer, header_, pattern_len);
-    pattern_len += 4;
-    return result;
+    return true;
   }
 
   static bool parse_header(proof_trace_buffer &buffer, uint32_t &version) {
@@ -323,13 +403,12 @@ private:
       return false;
     }
 
-    uint64_t pattern_len = 0;
-    auto kore_term = parse_kore_term(buffer, pattern_len);
-    if (!kore_term) {
+    llvm_kore_term kore_term;
+    if (!parse_kore_term(buffer, kore_term)) {
       return false;
     }
 
-    event->add_substitution(name, kore_term, pattern_len);
+    event->add_substitution(name, kore_term);
 
     return true;
   }
@@ -368,12 +447,11 @@ private:
       return nullptr;
     }
 
-    uint64_t pattern_len = 0;
-    auto kore_term = parse_kore_term(buffer, pattern_len);
-    if (!kore_term) {
+    llvm_kore_term kore_term;
+    if (!parse_kore_term(buffer, kore_term)) {
       return nullptr;
     }
-    event->setkore_pattern(kore_term, pattern_len);
+    event->set_result(kore_term);
 
     return event;
   }
@@ -410,18 +488,12 @@ private:
     return event;
   }
 
-  sptr<kore_pattern>
-  parse_config(proof_trace_buffer &buffer, uint64_t &pattern_len) {
+  bool parse_config(proof_trace_buffer &buffer, llvm_kore_term &config) {
     if (!buffer.check_word(config_sentinel)) {
-      return nullptr;
-    }
-
-    auto kore_term = parse_kore_term(buffer, pattern_len);
-    if (!kore_term) {
-      return nullptr;
+      return false;
     }
 
-    return kore_term;
+    return parse_kore_term(buffer, config);
   }
 
   sptr<llvm_rule_event> parse_rule(proof_trace_buffer &buffer) {
@@ -450,6 +522,20 @@ private:
     return event;
   }
 
+  static sptr<llvm_elided_rule_event>
+  parse_elided_rule(proof_trace_buffer &buffer) {
+    if (!buffer.check_word(rule_elided_sentinel)) {
+      return nullptr;
+    }
+
+    uint64_t ordinal = 0;
+    if (!buffer.read_uint64(ordinal)) {
+      return nullptr;
+    }
+
+    return llvm_elided_rule_event::create(ordinal);
+  }
+
   sptr<llvm_side_condition_event>
   parse_side_condition(proof_trace_buffer &buffer) {
     if (!buffer.check_word(side_condition_event_sentinel)) {
@@ -502,12 +588,11 @@ private:
 
   bool parse_argument(proof_trace_buffer &buffer, llvm_event &event) {
     if (!buffer.eof() && buffer.peek() == '\x7F') {
-      uint64_t pattern_len = 0;
-      auto kore_term = parse_kore_term(buffer, pattern_len);
-      if (!kore_term) {
+      llvm_kore_term kore_term;
+      if (!parse_kore_term(buffer, kore_term)) {
         return false;
       }
-      event.setkore_pattern(kore_term, pattern_len);
+      event.set_kore_term(kore_term);
 
       return true;
     }
@@ -545,6 +630,15 @@ private:
       return true;
     }
 
+    case rule_elided_sentinel: {
+      auto elided_event = parse_elided_rule(buffer);
+      if (!elided_event) {
+        return false;
+      }
+      event.set_step_event(elided_event);
+      return true;
+    }
+
     case side_condition_event_sentinel: {
       auto side_condition_event = parse_side_condition(buffer);
       if (!side_condition_event) {
@@ -580,6 +674,8 @@ private:
 
     case rule_event_sentinel: return parse_rule(buffer);
 
+    case rule_elided_sentinel: return parse_elided_rule(buffer);
+
     case side_condition_event_sentinel: return parse_side_condition(buffer);
 
     case side_condition_end_sentinel: return parse_side_condition_end(buffer);
@@ -594,12 +690,11 @@ private:
     }
 
     if (buffer.peek_word() == config_sentinel) {
-      uint64_t pattern_len = 0;
-      auto config = parse_config(buffer, pattern_len);
-      if (!config) {
+      llvm_kore_term config;
+      if (!parse_config(buffer, config)) {
         return false;
       }
-      event.setkore_pattern(config, pattern_len);
+      event.set_kore_term(config);
     } else {
       auto step_event = parse_step_event(buffer);
       if (!step_event) {
@@ -626,13 +721,12 @@ private:
       trace.add_pre_trace_event(event);
     }
 
-    uint64_t pattern_len = 0;
-    auto config = parse_config(buffer, pattern_len);
-    if (!config) {
+    llvm_kore_term config;
+    if (!parse_config(buffer, config)) {
       return false;
     }
     llvm_event config_event;
-    config_event.setkore_pattern(config, pattern_len);
+    config_event.set_kore_term(config);
     trace.set_initial_config(config_event);
 
     while (!buffer.eof()) {
@@ -647,8 +741,11 @@ private:
   }
 
 public:
+  // If lazy is set, the terms of the trace are only decoded when their
+  // patterns are requested.
   proof_trace_parser(
-      bool verbose, bool expand_terms, kore_header const &header);
+      bool verbose, bool expand_terms, kore_header const &header,
+      bool lazy = false);
 
   std::optional<llvm_rewrite_trace>
   parse_proof_trace_from_file(std::string const &filename);
@@ -657,6 +754,29 @@ public:
   friend class llvm_rewrite_trace_iterator;
 };
 
+// Receives the events of a proof trace one at a time from
+// llvm_rewrite_trace_iterator::visit, so that a trace can be processed without
+// ever being held in memory as a whole. Events nested in a function or hook
+// event are reached through that event.
+class llvm_rewrite_trace_visitor {
+public:
+  virtual ~llvm_rewrite_trace_visitor() = default;
+
+  virtual void version(uint32_t version) { }
+  virtual void config(llvm_event_type type, llvm_kore_term const &config) { }
+  virtual void rule(llvm_event_type type, llvm_rule_event const &event) { }
+  virtual void
+  elided_rule(llvm_event_type type, llvm_elided_rule_event const &event) { }
+  virtual void
+  side_condition(llvm_event_type type, llvm_side_condition_event const &event) {
+  }
+  virtual void side_condition_end(
+      llvm_event_type type, llvm_side_condition_end_event const &event) { }
+  virtual void
+  function(llvm_event_type type, llvm_function_event const &event) { }
+  virtual void hook(llvm_event_type type, llvm_hook_event const &event) { }
+};
+
 class llvm_rewrite_trace_iterator {
 private:
   uint32_t version_{};
@@ -666,9 +786,12 @@ private:
 
 public:
   llvm_rewrite_trace_iterator(
-      std::unique_ptr<proof_trace_buffer> buffer, kore_header const &header);
+      std::unique_ptr<proof_trace_buffer> buffer, kore_header const &header,
+      bool lazy = false);
   [[nodiscard]] uint32_t get_version() const { return version_; }
   std::optional<annotated_llvm_event> get_next_event();
+  // Reports the version and every remaining event of the trace to visitor.
+  void visit(llvm_rewrite_trace_visitor &visitor);
   void print(std::ostream &out, bool expand_terms, unsigned indent = 0U);
 };
 
@@ -443,6 +443,12 @@ sptr<kore_pattern> read_v2(
     proof_trace_buffer &buffer, kore_header const &header,
     uint64_t &pattern_len);
 
+// Reads a term in the format read by read_v2 and appends its bytes to bytes,
+// without decoding it into a pattern. pattern_len is updated as by read_v2.
+void read_v2_bytes(
+    proof_trace_buffer &buffer, kore_header const &header, std::string &bytes,
+    uint64_t &pattern_len);
+
 } // namespace detail
 
 std::string file_contents(std::string const &fn, int max_bytes = -1);
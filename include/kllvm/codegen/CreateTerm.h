@@ -19,6 +19,7 @@ private:
   llvm::LLVMContext &ctx_;
   bool is_anywhere_owise_;
   std::set<kore_pattern *> static_terms_;
+  std::set<kore_pattern *> hoisted_calls_;
 
   llvm::Value *alloc_arg(
       kore_composite_pattern *pattern, int idx, bool is_hook_arg,
@@ -26,6 +27,14 @@ private:
   llvm::Value *create_hook(
       kore_composite_pattern *hook_att, kore_composite_pattern *pattern,
       std::string const &location_stack = "");
+  llvm::Value *create_fixed_width_int(
+      std::string const &name, kore_composite_pattern *pattern,
+      std::string const &location_stack);
+  llvm::Value *create_word_arg(
+      kore_composite_pattern *pattern, int idx, unsigned width,
+      std::string const &location_stack);
+  llvm::Value *create_words_buffer(unsigned width);
+  llvm::Value *create_int_from_word(llvm::Value *word, bool is_signed);
   llvm::Value *create_function_call(
       std::string const &name, kore_composite_pattern *pattern, bool sret,
       bool tailcc, bool is_hook, std::string const &location_stack = "");
@@ -33,8 +42,21 @@ private:
       kore_composite_pattern *constructor, llvm::Value *val,
       std::string const &location_stack = "");
   bool populate_static_set(kore_pattern *pattern);
+  bool populate_hoisted_set(kore_pattern *pattern);
+  llvm::Value *create_hoisted_call(
+      kore_composite_pattern *pattern, std::string const &location_stack);
+  llvm::Value *create_function_allocation(
+      kore_composite_pattern *constructor, std::string const &location_stack);
   std::pair<llvm::Value *, bool> create_allocation(
       kore_pattern *pattern, std::string const &location_stack = "");
+  bool split_equality(
+      kore_pattern *lhs, kore_pattern *rhs,
+      std::vector<std::pair<kore_pattern *, kore_pattern *>> &operands);
+  llvm::Value *create_string_equality(llvm::Value *lhs, llvm::Value *rhs);
+  llvm::Value *create_value_equality(
+      kore_pattern *pattern, llvm::Value *lhs, llvm::Value *rhs);
+  llvm::Value *create_equality(
+      kore_composite_pattern *pattern, std::string const &location_stack);
   llvm::Value *disable_gc();
   void enable_gc(llvm::Value *was_enabled);
 
@@ -82,6 +104,15 @@ public:
 
 std::string escape(std::string const &str);
 
+/* emits code at the end of the specified block comparing two terms of the
+   Symbol category with the semantics of hook_KEQUAL_eq, and returns the
+   boolean result. Pointer-equal terms and constant constructors are decided
+   inline; other terms are passed to the runtime. On return, block is the block
+   in which the result is available. */
+llvm::Value *create_kequal_eq(
+    llvm::Value *lhs, llvm::Value *rhs, llvm::BasicBlock *&block,
+    llvm::Module *module);
+
 /* Creates a new llvm::Module with the predefined declarations common to all
    llvm modules in the llvm backend. */
 std::unique_ptr<llvm::Module>
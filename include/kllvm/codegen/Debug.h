@@ -17,7 +17,9 @@
 
 namespace kllvm {
 
-void init_debug_info(llvm::Module *module, std::string const &filename);
+void init_debug_info(
+    llvm::Module *module, std::string const &filename,
+    bool line_tables_only = false);
 void finalize_debug_info();
 
 void init_debug_function(
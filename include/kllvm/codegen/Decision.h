@@ -234,6 +234,16 @@ private:
       , cat_(cat)
       , type_(type) { }
 
+  /* emits a call to the fresh generator of the sort of a fresh constant
+     directly, rather than dispatching on the sort name at run time. Returns
+     null if the call cannot be resolved statically. */
+  llvm::Value *
+  codegen_fresh_constant(decision *d, std::vector<llvm::Value *> const &args);
+
+  /* emits counter + 1 for the generated counter, without calling into the
+     integer hooks unless the counter no longer fits in a single limb. */
+  llvm::Value *codegen_increment_counter(decision *d, llvm::Value *counter);
+
 public:
   ~function_node() override = default;
   static function_node *create(
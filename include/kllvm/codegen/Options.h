@@ -8,13 +8,21 @@ enum class opt_level { O0, O1, O2, O3 };
 extern llvm::cl::OptionCategory codegen_lib_cat;
 
 extern llvm::cl::opt<bool> debug;
+extern llvm::cl::opt<bool> debug_line_tables_only;
 extern llvm::cl::opt<bool> no_optimize;
 extern llvm::cl::opt<bool> emit_object;
 extern llvm::cl::opt<bool> binary_ir;
 extern llvm::cl::opt<bool> force_binary;
 extern llvm::cl::opt<bool> proof_hint_instrumentation;
 extern llvm::cl::opt<bool> proof_hint_instrumentation_slow;
+extern llvm::cl::list<std::string> proof_hint_filter;
 extern llvm::cl::opt<bool> keep_frame_pointer;
+extern llvm::cl::opt<bool> hoist_ground_calls;
+extern llvm::cl::opt<bool> merge_functions;
+extern llvm::cl::opt<bool> hot_cold_split;
+extern llvm::cl::opt<bool> pretenure_online;
+extern llvm::cl::opt<std::string> pretenure_profile;
+extern llvm::cl::opt<double> pretenure_threshold;
 extern llvm::cl::opt<opt_level> optimization_level;
 
 namespace kllvm {
@@ -9,28 +9,65 @@
 #include "llvm/IR/Instructions.h"
 
 #include <map>
+#include <optional>
 #include <tuple>
 
 namespace kllvm {
 
+/*
+ * Bits of the runtime `proof_hint_mask` global. An event whose kind is masked
+ * out at run time is not written to the trace; a masked out rewrite step is
+ * recorded as an elided rule instead.
+ */
+enum class proof_hint_kind : uint64_t {
+  Rule = 1,
+  Function = 2,
+  Hook = 4,
+  SideCondition = 8,
+};
+
 class proof_event {
 private:
   kore_definition *definition_;
   llvm::Module *module_;
   llvm::LLVMContext &ctx_;
 
+  /*
+   * Returns true if events for this rule should be instrumented according to
+   * the `--proof-hint-filter` option; a rule is selected by its label, or by
+   * the module prefix of its label. Unlabelled rules are selected by the
+   * module that declares them.
+   */
+  static bool is_selected(kore_axiom_declaration const &axiom);
+
+  /*
+   * Returns true if function and hook events for calls to the symbol of this
+   * pattern should be instrumented according to the `--proof-hint-filter`
+   * option; a symbol is selected by its name, its hook, or the namespace of
+   * its hook.
+   */
+  bool is_selected(kore_composite_pattern *pattern);
+
   /*
    * Load the boolean flag that controls whether proof hint output is enabled or
    * not, then create a branch at the end of this basic block depending on the
-   * result.
+   * result. If `kind` is given, the branch is also only taken when that kind of
+   * event is enabled by the runtime mask.
    *
    * Returns a pair of blocks [proof enabled, merge]; the first of these is
    * intended for self-contained behaviour only relevant in proof output mode,
    * while the second is for the continuation of the interpreter's previous
    * behaviour.
    */
-  std::pair<llvm::BasicBlock *, llvm::BasicBlock *>
-  proof_branch(std::string const &label, llvm::BasicBlock *insert_at_end);
+  std::pair<llvm::BasicBlock *, llvm::BasicBlock *> proof_branch(
+      std::string const &label, llvm::BasicBlock *insert_at_end,
+      std::optional<proof_hint_kind> kind = std::nullopt);
+
+  /*
+   * Emit a test of whether `kind` is enabled by the runtime mask.
+   */
+  llvm::Value *
+  emit_kind_enabled(proof_hint_kind kind, llvm::BasicBlock *insert_at_end);
 
   /*
    * Set up a standard event prelude by creating a pair of basic blocks for the
@@ -41,7 +78,9 @@ private:
    * `emitGetOutputFileName`.
    */
   std::tuple<llvm::BasicBlock *, llvm::BasicBlock *, llvm::Value *>
-  event_prelude(std::string const &label, llvm::BasicBlock *insert_at_end);
+  event_prelude(
+      std::string const &label, llvm::BasicBlock *insert_at_end,
+      std::optional<proof_hint_kind> kind = std::nullopt);
 
   /*
    * Emit a call that will serialize `term` to the specified `outputFile` as
@@ -96,12 +135,15 @@ public:
       llvm::BasicBlock *current_block, std::string const &location_stack);
 
   [[nodiscard]] llvm::BasicBlock *hook_event_post(
-      llvm::Value *val, kore_composite_sort *sort,
-      llvm::BasicBlock *current_block);
+      llvm::Value *val, kore_composite_pattern *pattern,
+      kore_composite_sort *sort, llvm::BasicBlock *current_block);
 
+  /*
+   * `call` is the function or hook call that this is an argument of.
+   */
   [[nodiscard]] llvm::BasicBlock *argument(
-      llvm::Value *val, kore_composite_sort *sort, bool is_hook_arg,
-      llvm::BasicBlock *current_block);
+      llvm::Value *val, kore_composite_pattern *call, kore_composite_sort *sort,
+      bool is_hook_arg, llvm::BasicBlock *current_block);
 
   [[nodiscard]] llvm::BasicBlock *rewrite_event_pre(
       kore_axiom_declaration const &axiom, uint64_t arity,
@@ -117,8 +159,8 @@ public:
       llvm::BasicBlock *current_block, kore_composite_pattern *pattern,
       std::string const &location_stack);
 
-  [[nodiscard]] llvm::BasicBlock *
-  function_event_post(llvm::BasicBlock *current_block);
+  [[nodiscard]] llvm::BasicBlock *function_event_post(
+      llvm::BasicBlock *current_block, kore_composite_pattern *pattern);
 
   [[nodiscard]] llvm::BasicBlock *side_condition_event_pre(
       kore_axiom_declaration const &axiom,
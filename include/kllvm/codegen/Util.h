@@ -7,6 +7,7 @@
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
 
@@ -42,6 +43,11 @@ llvm::Function *get_or_insert_function(llvm::Module *module, Ts &&...args) {
 
 char const *get_collection_alloc_fn(sort_category cat);
 
+// Attaches branch weights to a conditional branch marking the successor with
+// the given index as rarely taken, so that the code generator lays it out away
+// from the hot path.
+void set_cold_successor(llvm::BranchInst *branch, unsigned idx);
+
 void insert_call_to_clear(llvm::BasicBlock *bb);
 
 } // namespace kllvm
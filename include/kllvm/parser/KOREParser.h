@@ -12,6 +12,20 @@
 
 namespace kllvm::parser {
 
+/* Receives the subpatterns of a pattern parsed by kore_parser::pattern(handler)
+   in post-order, so that a consumer can build its own representation of a
+   large pattern without an AST for it being held in memory. */
+class pattern_handler {
+public:
+  virtual ~pattern_handler() = default;
+
+  /* a string literal */
+  virtual void string(std::string const &contents) = 0;
+  /* an application of the specified symbol, printed as by ast_to_string, to
+     the arity patterns reported last */
+  virtual void application(std::string const &symbol, size_t arity) = 0;
+};
+
 class kore_parser {
 public:
   kore_parser(std::string const &filename)
@@ -22,6 +36,11 @@ public:
 
   ptr<kore_definition> definition();
   sptr<kore_pattern> pattern();
+  /* parses a pattern without variables, reporting it to handler rather than
+     building an AST. \left-assoc and \right-assoc are reported as the
+     binary applications they stand for. The pattern is parsed with an
+     explicit stack, so it may be nested arbitrarily deeply. */
+  void pattern(pattern_handler &handler);
   sptr<kore_sort> sort();
   ptr<kore_symbol> symbol();
   std::vector<ptr<kore_declaration>> declarations();
@@ -57,6 +76,9 @@ private:
   template <typename Node>
   void sorts_ne(Node *node);
 
+  std::string sort_text();
+  std::string symbol_text(std::string const &name);
+
   sptr<kore_pattern> pattern_internal();
   void patterns(kore_composite_pattern *node);
   void patterns_ne(kore_composite_pattern *node);
@@ -25,11 +25,20 @@ using map_impl = map::iterator::tree_t;
 using set_node = set::iterator::node_t;
 using set_impl = set::iterator::tree_t;
 
+// Blocks allocated directly into the old generation by pretenured allocation
+// sites since the last collection. They may point to young terms, so the
+// collector scans them before anything else and promotes what they reach.
+extern std::vector<block *> pretenured_blocks;
+
 extern "C" {
 extern size_t numBytesLiveAtCollection[1 << AGE_WIDTH];
 extern bool collect_old;
+// set while the collector promotes every young term it reaches
+extern bool promote_young;
 size_t get_size(uint64_t, uint16_t);
 void migrate_static_roots(void);
+void register_hoisted_root(void *root, uint16_t cat);
+void migrate_hoisted_roots(void);
 void migrate(block **block_ptr);
 void migrate_once(block **);
 void migrate_list(void *l);
@@ -39,6 +48,20 @@ void migrate_set(void *s);
 void migrate_collection_node(void **node_ptr);
 void set_kore_memory_functions_for_gmp(void);
 void kore_collect(void **, uint8_t, layoutitem *);
+
+// allocates requested bytes for a block with the specified header into the old
+// generation, writes the header and remembers the block in pretenured_blocks.
+// called by allocation sites that the code generator has pretenured.
+void *kore_alloc_pretenured(size_t requested, uint64_t hdr);
+// allocates requested bytes for a block with the specified header and writes
+// the header. the block is pretenured once blocks with the same tag have been
+// observed to survive into the old generation often enough.
+void *kore_alloc_adaptive(size_t requested, uint64_t hdr);
+// records that a young block with the specified header has been promoted,
+// unless promote_young forced the promotion
+void record_promotion(uint64_t hdr);
+// decides which tags to pretenure from now on; called after each collection
+void update_pretenured_tags(void);
 }
 
 #ifdef GC_DBG
@@ -56,7 +79,7 @@ void kore_collect(void **, uint8_t, layoutitem *);
 #define INITIALIZE_AGE() bool age = hdr & AGE_MASK;
 #define increment_age()
 #define MIGRATE_HEADER(block)                                                  \
-  block->h.hdr |= shouldPromote ? NOT_YOUNG_OBJECT_BIT : AGE_MASK
+  block->h.hdr |= shouldPromote ? NOT_YOUNG_OBJECT_BIT | AGE_MASK : AGE_MASK
 #endif
 
 #define INITIALIZE_MIGRATE()                                                   \
@@ -65,7 +88,7 @@ void kore_collect(void **, uint8_t, layoutitem *);
   if (!(isInYoungGen || (isInOldGen && collect_old))) {                        \
     return;                                                                    \
   }                                                                            \
-  bool shouldPromote = isInYoungGen && age;                                    \
+  bool shouldPromote = isInYoungGen && (age || promote_young);                 \
   increment_age() bool hasForwardingAddress = hdr & FWD_PTR_BIT
 
 #endif // RUNTIME_COLLECT_H
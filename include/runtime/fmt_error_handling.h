@@ -3,11 +3,16 @@
 
 #include <fmt/format.h>
 
+// The message is formatted and thrown from a separate cold function, so that
+// the formatting code stays out of the body of the hook.
 #define KLLVM_HOOK_INVALID_ARGUMENT(...)                                       \
   do {                                                                         \
-    auto err_msg                                                               \
-        = ::fmt::format("[{}]: {}", __func__, ::fmt::format(__VA_ARGS__));     \
-    throw std::invalid_argument(err_msg);                                      \
+    char const *kllvm_hook_name = __func__;                                    \
+    [&]() __attribute__((cold, noinline, noreturn)) {                          \
+      auto err_msg = ::fmt::format(                                            \
+          "[{}]: {}", kllvm_hook_name, ::fmt::format(__VA_ARGS__));            \
+      throw std::invalid_argument(err_msg);                                    \
+    }();                                                                       \
   } while (false)
 
 #endif // FMT_ERROR_HANDLING_H
@@ -74,6 +74,21 @@ using stringbuffer = struct stringbuffer {
   string *contents;
 };
 
+// A rope is the result of concatenating two long strings without copying
+// them. It is laid out like a block with two children so that the garbage
+// collector can trace it, and is distinguished from a flat string by its
+// reserved layout ROPE_LAYOUT. Each child is either a flat string or another
+// rope. Once a rope has been flattened, both children point to the flattened
+// string and its depth is zero.
+// llvm: rope = type { %blockheader, %string *, %string *, i64, i64 }
+using rope = struct rope {
+  blockheader h;
+  string *left;
+  string *right;
+  uint64_t length;
+  uint64_t depth;
+};
+
 using mpz_hdr = struct mpz_hdr {
   blockheader h;
   mpz_t i;
@@ -186,6 +201,11 @@ __attribute__((always_inline)) inline bool is_variable_block(T const *b) {
   return (reinterpret_cast<uintptr_t>(b) & 3) == 3;
 }
 
+template <typename T>
+__attribute__((always_inline)) inline bool is_rope(T const *s) {
+  return !is_leaf_block(s) && layout_hdr(s->h.hdr) == ROPE_LAYOUT;
+}
+
 template <typename T>
 __attribute__((always_inline)) constexpr bool is_heap_block(T const *s) {
   return is_in_young_gen_hdr(s->h.hdr) || is_in_old_gen_hdr(s->h.hdr);
@@ -295,6 +315,9 @@ using SortRange = block *;
 using SortRangeMap = rangemap *;
 
 void *construct_composite_pattern(uint32_t tag, std::vector<void *> &arguments);
+// Applies the normalizations of construct_composite_pattern to a constructor
+// block whose children have already been stored.
+block *finish_composite_block(block *term);
 
 extern "C" {
 
@@ -330,12 +353,21 @@ sorted_term_to_kore_pattern(block *, char const *);
 string *debug_print_term(block *subject, char const *sort);
 
 mpz_ptr move_int(mpz_t);
+// If i is small enough to be cached, clears it and returns the shared,
+// statically allocated Int with its value; otherwise returns null.
+mpz_ptr small_int(mpz_t i);
 
 void serialize_configurations(
     FILE *file, std::unordered_set<block *, hash_block, k_eq> results);
 void serialize_configuration(
     block *subject, char const *sort, char **data_out, size_t *size_out,
     bool emit_size, bool use_intern);
+// As serialize_configuration, but writes the serialized bytes into the buffer
+// returned by allocate(size, context) rather than into a malloc'd copy. If
+// allocate returns null, nothing is written. Returns the size.
+size_t serialize_configuration_with_allocator(
+    block *subject, char const *sort, bool emit_size, bool use_intern,
+    char *(*allocate)(size_t size, void *context), void *context);
 void serialize_configuration_v2(FILE *file, block *subject, uint32_t sort);
 void serialize_configuration_to_file(
     FILE *file, block *subject, bool emit_size, bool use_intern);
@@ -417,6 +449,14 @@ void visit_children(
 void visit_children_for_serialize(
     block *subject, writer *file, serialize_visitor *printer);
 
+// Returns a flat string with the same contents as its argument, which may be a
+// rope. The result is cached in the rope, so flattening it again is constant
+// time.
+string *flatten_string(string *);
+// Returns the length in bytes of a flat string or a rope.
+uint64_t rope_length(string *);
+string *rope_concat(string *, string *);
+
 stringbuffer *hook_BUFFER_empty(void);
 stringbuffer *hook_BUFFER_concat(stringbuffer *buf, string *s);
 stringbuffer *
@@ -426,6 +466,9 @@ string *hook_BUFFER_toString(stringbuffer *buf);
 size_t hook_SET_size_long(set *);
 
 mpz_ptr hook_MINT_import(size_t *i, uint64_t bits, bool is_signed);
+// Writes the low nwords 64-bit words of the two's complement representation of
+// in to out, least significant first.
+void int_low_words(mpz_t in, uint64_t *out, uint64_t nwords);
 
 block *debruijnize(block *);
 block *increment_debruijn(block *);
@@ -93,21 +93,42 @@ sptr<kore_pattern> kore_pattern::expand_macros(
     std::vector<ptr<kore_declaration>> const &axioms, bool reverse) {
   std::set<size_t> applied_rules;
 
-  std::set<std::string> macro_symbols;
-
-  for (auto const &decl : axioms) {
-    auto *axiom = dynamic_cast<kore_axiom_declaration *>(decl.get());
+  auto get_lhs = [&](kore_declaration *decl) {
+    auto *axiom = dynamic_cast<kore_axiom_declaration *>(decl);
     auto *equals
         = dynamic_cast<kore_composite_pattern *>(axiom->get_pattern().get());
-    auto lhs = equals->get_arguments()[reverse ? 1 : 0];
+    return equals->get_arguments()[reverse ? 1 : 0];
+  };
+
+  MacroIndex macro_index;
+  for (auto const &decl : axioms) {
+    auto lhs = get_lhs(decl.get());
+    if (auto *lhs_comp = dynamic_cast<kore_composite_pattern *>(lhs.get())) {
+      macro_index[lhs_comp->get_constructor()->get_name()];
+    }
+  }
 
+  // A macro whose left-hand side is a variable can apply under any head
+  // symbol, so it is a candidate for every entry in the index.
+  for (size_t i = 0; i < axioms.size(); ++i) {
+    auto const &decl = axioms[i];
+    if ((decl->attributes().contains(attribute_set::key::Macro)
+         || decl->attributes().contains(attribute_set::key::MacroRec))
+        && reverse) {
+      continue;
+    }
+    auto lhs = get_lhs(decl.get());
     if (auto *lhs_comp = dynamic_cast<kore_composite_pattern *>(lhs.get())) {
-      macro_symbols.insert(lhs_comp->get_constructor()->get_name());
+      macro_index[lhs_comp->get_constructor()->get_name()].push_back(i);
+    } else if (dynamic_cast<kore_variable_pattern *>(lhs.get())) {
+      for (auto &[name, indices] : macro_index) {
+        indices.push_back(i);
+      }
     }
   }
 
   return expand_macros(
-      subsorts, overloads, axioms, reverse, applied_rules, macro_symbols);
+      subsorts, overloads, axioms, reverse, applied_rules, macro_index);
 }
 
 bool kore_sort_variable::operator==(kore_sort const &other) const {
@@ -414,14 +435,42 @@ kore_composite_pattern::expand_aliases(kore_definition *def) {
 static int indent = 0;
 static bool at_new_line = true;
 
-static void newline(std::ostream &out) {
+static constexpr auto indent_size = 2;
+
+/*
+ * Sort keys computed so far by the outermost call to sort_collections, and the
+ * indentation record of the key currently being printed, if any.
+ */
+struct kllvm::sort_key_cache {
+  /*
+   * The uncolored pretty-printed form of a collection element, as printed at
+   * indentation level zero. It is used as the key by which the elements of
+   * associative-commutative collections are sorted. Because the indentation
+   * of a term depends on where it is printed, we also record where each line
+   * was indented and at which relative level, so that the key can be spliced
+   * into the key of an enclosing term without printing the element again.
+   */
+  struct sort_key {
+    std::string text;
+    std::vector<std::pair<size_t, int>> indents;
+    int indent_delta{};
+    bool at_new_line{};
+  };
+
+  std::unordered_map<kore_pattern const *, sort_key> keys;
+  std::vector<std::pair<size_t, int>> *indents = nullptr;
+  bool started = false;
+};
+
+static void newline(std::ostream &out, pretty_print_data const &data) {
   out << std::endl;
   at_new_line = true;
+  if (data.sort_keys) {
+    data.sort_keys->started = true;
+  }
 }
 
 static void print_indent(std::ostream &out) {
-  constexpr auto indent_size = 2;
-
   if (at_new_line) {
     for (int i = 0; i < indent_size * indent; i++) {
       out << ' ';
@@ -430,6 +479,20 @@ static void print_indent(std::ostream &out) {
   }
 }
 
+static void record_indent(std::ostream &out, pretty_print_data const &data) {
+  auto *keys = data.sort_keys;
+  if (!keys) {
+    return;
+  }
+  // The first line of a key is recorded even though it is not indented when
+  // the key is printed, since it will be if the key is spliced in at the start
+  // of a line.
+  if (keys->indents && (at_new_line || !keys->started)) {
+    keys->indents->emplace_back(static_cast<size_t>(out.tellp()), indent);
+  }
+  keys->started = true;
+}
+
 static void append(std::ostream &out, char c) {
   print_indent(out);
   out << c;
@@ -440,10 +503,25 @@ static void append(std::ostream &out, std::string const &str) {
   out << str;
 }
 
+static void append(std::ostream &out, char c, pretty_print_data const &data) {
+  record_indent(out, data);
+  append(out, c);
+}
+
+static void append(
+    std::ostream &out, std::string const &str, pretty_print_data const &data) {
+  record_indent(out, data);
+  append(out, str);
+}
+
+static bool has_color(pretty_print_data const &data) {
+  return data.has_color && !(data.sort_keys && data.sort_keys->indents);
+}
+
 static void color(
     std::ostream &out, std::string const &color,
     pretty_print_data const &data) {
-  if (data.has_color) {
+  if (has_color(data)) {
     static bool once = true;
     static std::map<std::string, std::string> colors;
     if (once) {
@@ -647,7 +725,7 @@ static void color(
       colors["SlateGrey"] = "\x1b[38;5;102m";
       once = false;
     }
-    append(out, colors[color]);
+    append(out, colors[color], data);
   }
 }
 
@@ -699,11 +777,57 @@ void kore_composite_sort::pretty_print(std::ostream &out) const {
 
 void kore_variable_pattern::pretty_print(
     std::ostream &out, pretty_print_data const &data) const {
-  append(out, decode_kore(get_name().substr(3)));
-  append(out, ':');
+  append(out, decode_kore(get_name().substr(3)), data);
+  append(out, ':', data);
   sort_->pretty_print(out);
 }
 
+/*
+ * Prints a previously computed sort key at the current indentation, producing
+ * exactly the output that printing the term it was computed from would.
+ */
+static void append_sort_key(
+    std::ostream &out, sort_key_cache::sort_key const &key,
+    pretty_print_data const &data) {
+  if (key.text.empty() && key.indents.empty()) {
+    return;
+  }
+  int base = indent;
+  size_t start = 0;
+  if (key.indents.empty() || key.indents.front().first != 0) {
+    data.sort_keys->started = true;
+  }
+  for (auto const &[offset, level] : key.indents) {
+    out.write(key.text.data() + start, offset - start);
+    // Every line but the first follows a newline. The first line is only
+    // indented if the enclosing term is at the start of a line, and was not
+    // indented in the key itself.
+    if (offset != 0) {
+      at_new_line = true;
+      start = offset + indent_size * std::max(0, level);
+    }
+    indent = base + level;
+    record_indent(out, data);
+    print_indent(out);
+  }
+  out.write(key.text.data() + start, key.text.size() - start);
+  indent = base + key.indent_delta;
+  at_new_line = key.at_new_line;
+}
+
+static void pretty_print_argument(
+    std::ostream &out, kore_pattern *inner, pretty_print_data const &data) {
+  if (data.sort_keys && data.sort_keys->indents) {
+    auto const &keys = data.sort_keys->keys;
+    auto key = keys.find(inner);
+    if (key != keys.end()) {
+      append_sort_key(out, key->second, data);
+      return;
+    }
+  }
+  inner->pretty_print(out, data);
+}
+
 // NOLINTNEXTLINE(*-cognitive-complexity)
 void kore_composite_pattern::pretty_print(
     std::ostream &out, pretty_print_data const &data) const {
@@ -716,15 +840,15 @@ void kore_composite_pattern::pretty_print(
     if (has_hook) {
       auto hook = data.hook.at(s->get_name());
       if (hook == "STRING.String") {
-        append(out, enquote(str->get_contents()));
+        append(out, enquote(str->get_contents()), data);
       } else if (hook == "BYTES.Bytes") {
-        append(out, 'b');
-        append(out, enquote(str->get_contents()));
+        append(out, 'b', data);
+        append(out, enquote(str->get_contents()), data);
       } else {
-        append(out, str->get_contents());
+        append(out, str->get_contents(), data);
       }
     } else {
-      append(out, str->get_contents());
+      append(out, str->get_contents(), data);
     }
     return;
   }
@@ -741,7 +865,7 @@ void kore_composite_pattern::pretty_print(
         char c2 = format[i + 1];
         ++i;
         switch (c2) {
-        case 'n': newline(out); break;
+        case 'n': newline(out, data); break;
         case 'i':
           indent++;
           local_indent++;
@@ -759,8 +883,8 @@ void kore_composite_pattern::pretty_print(
           }
           break;
         case 'r':
-          if (data.has_color) {
-            append(out, RESET_COLOR);
+          if (has_color(data)) {
+            append(out, RESET_COLOR, data);
           }
           break;
         case '0':
@@ -795,21 +919,21 @@ void kore_composite_pattern::pretty_print(
                 indent--;
               }
             }
-            inner->pretty_print(out, data);
+            pretty_print_argument(out, inner, data);
             if (assoc) {
               for (int j = 0; j < local_indent; j++) {
                 indent++;
               }
             }
           } else {
-            inner->pretty_print(out, data);
+            pretty_print_argument(out, inner, data);
           }
           break;
         }
-        default: append(out, c2);
+        default: append(out, c2, data);
         }
       } else {
-        append(out, c);
+        append(out, c, data);
       }
     }
   } else {
@@ -899,30 +1023,59 @@ void kllvm::flatten(
   }
 }
 
+/*
+ * Computes the sort key of a collection element whose own collections have
+ * already been sorted. Nested elements that already have a key are spliced in
+ * rather than printed again, so each element is printed only once no matter
+ * how deeply its collections are nested.
+ */
+static std::string const &
+get_sort_key(kore_pattern *item, pretty_print_data const &data) {
+  auto *keys = data.sort_keys;
+  auto [it, inserted] = keys->keys.try_emplace(item);
+  auto &key = it->second;
+  if (!inserted) {
+    return key.text;
+  }
+  std::ostringstream out;
+  int old_indent = indent;
+  bool old_at_new_line = at_new_line;
+  at_new_line = false;
+  indent = 0;
+  keys->indents = &key.indents;
+  keys->started = false;
+  item->pretty_print(out, data);
+  keys->indents = nullptr;
+  key.text = out.str();
+  key.indent_delta = indent;
+  key.at_new_line = at_new_line;
+  indent = old_indent;
+  at_new_line = old_at_new_line;
+  return key.text;
+}
+
 sptr<kore_pattern>
 kore_composite_pattern::sort_collections(pretty_print_data const &data) {
   if (arguments_.empty()) {
     return shared_from_this();
   }
+  // Sort keys are cached for the duration of the outermost call; every
+  // element they are computed for is kept alive by the sorted result.
+  if (!data.sort_keys) {
+    sort_key_cache keys;
+    pretty_print_data new_data = data;
+    new_data.sort_keys = &keys;
+    return sort_collections(new_data);
+  }
   std::string name = get_constructor()->get_name();
   if (data.comm.contains(name) && data.assoc.contains(name)) {
     std::vector<sptr<kore_pattern>> items;
     flatten(this, name, items);
     std::vector<std::pair<std::string, sptr<kore_pattern>>> printed;
-    int old_indent = indent;
-    bool old_at_new_line = at_new_line;
-    at_new_line = false;
-    indent = 0;
-    pretty_print_data new_data = data;
-    new_data.has_color = false;
     for (auto &item : items) {
-      std::ostringstream out;
       item = item->sort_collections(data);
-      item->pretty_print(out, new_data);
-      printed.emplace_back(out.str(), item);
+      printed.emplace_back(get_sort_key(item.get(), data), item);
     }
-    indent = old_indent;
-    at_new_line = old_at_new_line;
     std::sort(printed.begin(), printed.end(), compare_first{});
     items.clear();
     for (auto &item : printed) {
@@ -1141,28 +1294,49 @@ sptr<kore_pattern> kore_composite_pattern::strip_injections() {
 sptr<kore_pattern> kore_composite_pattern::expand_macros(
     SubsortMap const &subsorts, SymbolMap const &overloads,
     std::vector<ptr<kore_declaration>> const &macros, bool reverse,
-    std::set<size_t> &applied_rules,
-    std::set<std::string> const &macro_symbols) {
+    std::set<size_t> &applied_rules, MacroIndex const &macro_index) {
   sptr<kore_composite_pattern> applied
       = kore_composite_pattern::create(constructor_.get());
   for (auto &arg : arguments_) {
     std::set<size_t> dummy_applied;
     applied->add_argument(arg->expand_macros(
-        subsorts, overloads, macros, reverse, dummy_applied, macro_symbols));
+        subsorts, overloads, macros, reverse, dummy_applied, macro_index));
   }
 
-  if (macro_symbols.find(constructor_->get_name()) == macro_symbols.end()) {
+  auto candidates = macro_index.find(constructor_->get_name());
+  if (candidates == macro_index.end()) {
     return applied;
   }
 
-  size_t i = 0;
-  for (auto const &decl : macros) {
-    if ((decl->attributes().contains(attribute_set::key::Macro)
-         || decl->attributes().contains(attribute_set::key::MacroRec))
-        && reverse) {
-      i++;
-      continue;
+  // An injection of an overloaded symbol can also be matched by macros for
+  // the symbols that overload it; see kore_composite_pattern::matches.
+  std::vector<size_t> const *indices = &candidates->second;
+  std::vector<size_t> with_overloads;
+  if (constructor_->get_name() == "inj") {
+    if (auto *child = dynamic_cast<kore_composite_pattern *>(
+            applied->arguments_[0].get())) {
+      auto greater = overloads.find(child->get_constructor());
+      if (greater != overloads.end()) {
+        with_overloads = *indices;
+        for (auto *symbol : greater->second) {
+          auto more = macro_index.find(symbol->get_name());
+          if (more != macro_index.end()) {
+            with_overloads.insert(
+                with_overloads.end(), more->second.begin(),
+                more->second.end());
+          }
+        }
+        std::sort(with_overloads.begin(), with_overloads.end());
+        with_overloads.erase(
+            std::unique(with_overloads.begin(), with_overloads.end()),
+            with_overloads.end());
+        indices = &with_overloads;
+      }
     }
+  }
+
+  for (size_t i : *indices) {
+    auto const &decl = macros[i];
     auto *axiom = dynamic_cast<kore_axiom_declaration *>(decl.get());
     auto *equals
         = dynamic_cast<kore_composite_pattern *>(axiom->get_pattern().get());
@@ -1174,25 +1348,74 @@ sptr<kore_pattern> kore_composite_pattern::expand_macros(
         && (decl->attributes().contains(attribute_set::key::MacroRec)
             || decl->attributes().contains(attribute_set::key::AliasRec)
             || !applied_rules.contains(i))) {
-      std::set<size_t> old_applied_rules = applied_rules;
-      applied_rules.insert(i);
+      bool inserted = applied_rules.insert(i).second;
       auto result = rhs->substitute(subst)->expand_macros(
-          subsorts, overloads, macros, reverse, applied_rules, macro_symbols);
-      applied_rules = old_applied_rules;
+          subsorts, overloads, macros, reverse, applied_rules, macro_index);
+      if (inserted) {
+        applied_rules.erase(i);
+      }
       return result;
     }
-    i++;
   }
   return applied;
 }
 
+/*
+ * Structural equality of patterns, which agrees with comparing their textual
+ * KORE but does not need to print them.
+ */
+static bool equal_patterns(kore_pattern *a, kore_pattern *b) {
+  if (a == b) {
+    return true;
+  }
+  if (auto *comp_a = dynamic_cast<kore_composite_pattern *>(a)) {
+    auto *comp_b = dynamic_cast<kore_composite_pattern *>(b);
+    if (!comp_b) {
+      return false;
+    }
+    auto *sym_a = comp_a->get_constructor();
+    auto *sym_b = comp_b->get_constructor();
+    auto const &formals_a = sym_a->get_formal_arguments();
+    auto const &formals_b = sym_b->get_formal_arguments();
+    auto const &args_a = comp_a->get_arguments();
+    auto const &args_b = comp_b->get_arguments();
+    if (sym_a->get_name() != sym_b->get_name()
+        || formals_a.size() != formals_b.size()
+        || args_a.size() != args_b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < formals_a.size(); ++i) {
+      if (*formals_a[i] != *formals_b[i]) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < args_a.size(); ++i) {
+      if (!equal_patterns(args_a[i].get(), args_b[i].get())) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (auto *var_a = dynamic_cast<kore_variable_pattern *>(a)) {
+    auto *var_b = dynamic_cast<kore_variable_pattern *>(b);
+    return var_b && var_a->get_name() == var_b->get_name()
+           && *var_a->get_sort() == *var_b->get_sort();
+  }
+  if (auto *str_a = dynamic_cast<kore_string_pattern *>(a)) {
+    auto *str_b = dynamic_cast<kore_string_pattern *>(b);
+    return str_b && str_a->get_contents() == str_b->get_contents();
+  }
+  return ast_to_string(*a) == ast_to_string(*b);
+}
+
 bool kore_variable_pattern::matches(
     substitution &subst, SubsortMap const &subsorts, SymbolMap const &overloads,
     sptr<kore_pattern> subject) {
-  if (subst[name_->get_name()]) {
-    return ast_to_string(*subst[name_->get_name()]) == ast_to_string(*subject);
+  auto &bound = subst[name_->get_name()];
+  if (bound) {
+    return equal_patterns(bound.get(), subject.get());
   }
-  subst[name_->get_name()] = subject;
+  bound = subject;
   return true;
 }
 
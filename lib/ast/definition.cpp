@@ -1,6 +1,8 @@
 #include <kllvm/ast/AST.h>
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <unordered_set>
 
@@ -64,6 +66,7 @@ void kore_definition::add_module(sptr<kore_module> module) {
           {alias_decl->get_symbol()->get_name(), alias_decl});
     } else if (
         auto *axiom = dynamic_cast<kore_axiom_declaration *>(decl.get())) {
+      axiom->module_name_ = module->get_name();
       axioms_.push_back(axiom);
     }
   }
@@ -171,6 +174,112 @@ SymbolMap kore_definition::get_overloads() const {
   return transitive_closure(overloads);
 }
 
+/*
+ * Returns the left- and right-hand sides of an axiom of the form
+ * \implies(_, \equals(f(...), \and(RHS, _))) or \equals(f(...), RHS), if
+ * the axiom has that form.
+ */
+static std::optional<std::pair<kore_composite_pattern *, kore_pattern *>>
+get_function_rule(kore_axiom_declaration *axiom) {
+  auto *top
+      = dynamic_cast<kore_composite_pattern *>(axiom->get_pattern().get());
+  if (top && top->get_constructor()->get_name() == "\\implies") {
+    top = dynamic_cast<kore_composite_pattern *>(top->get_arguments()[1].get());
+  }
+  if (!top || top->get_constructor()->get_name() != "\\equals") {
+    return std::nullopt;
+  }
+  auto *lhs
+      = dynamic_cast<kore_composite_pattern *>(top->get_arguments()[0].get());
+  auto *rhs = top->get_arguments()[1].get();
+  if (auto *conj = dynamic_cast<kore_composite_pattern *>(rhs);
+      conj && conj->get_constructor()->get_name() == "\\and") {
+    rhs = conj->get_arguments()[0].get();
+  }
+  if (!lhs) {
+    return std::nullopt;
+  }
+  return std::make_pair(lhs, rhs);
+}
+
+bool kore_definition::may_return_injection(std::string const &function_name) {
+  if (!injection_functions_) {
+    auto supersorts = get_supersorts();
+    auto injection_functions = std::unordered_set<std::string>{};
+
+    auto rules = std::map<std::string, std::vector<kore_pattern *>>{};
+    for (auto *axiom : axioms_) {
+      if (auto rule = get_function_rule(axiom)) {
+        auto const &name = rule->first->get_constructor()->get_name();
+        auto decl = symbol_declarations_.find(name);
+        if (decl != symbol_declarations_.end()
+            && decl->second->attributes().contains(
+                attribute_set::key::Function)) {
+          rules[name].push_back(rule->second);
+        }
+      }
+    }
+
+    for (auto const &[name, decl] : symbol_declarations_) {
+      if (decl->attributes().contains(attribute_set::key::Function)
+          && (decl->is_hooked()
+              || decl->attributes().contains(attribute_set::key::Hook)
+              || !rules.contains(name))) {
+        injection_functions.insert(name);
+      }
+    }
+
+    auto may_be_injection = [&](kore_pattern *rhs) {
+      if (auto *var = dynamic_cast<kore_variable_pattern *>(rhs)) {
+        auto *sort = dynamic_cast<kore_composite_sort *>(var->get_sort().get());
+        return !sort || !supersorts[sort].empty();
+      }
+      auto *comp = dynamic_cast<kore_composite_pattern *>(rhs);
+      if (!comp) {
+        return true;
+      }
+      auto const &name = comp->get_constructor()->get_name();
+      if (name == "\\dv") {
+        return false;
+      }
+      auto decl = symbol_declarations_.find(name);
+      if (decl == symbol_declarations_.end()) {
+        return true;
+      }
+      auto const &att = decl->second->attributes();
+      if (att.contains(attribute_set::key::Function)) {
+        return injection_functions.contains(name);
+      }
+      return att.contains(attribute_set::key::SortInjection)
+             || att.contains(attribute_set::key::Anywhere);
+    };
+
+    // Functions are assumed not to return injections until one of their
+    // rules shows otherwise; iterate until this reaches a fixed point.
+    bool dirty = false;
+    do {
+      dirty = false;
+      for (auto const &[name, rhss] : rules) {
+        if (injection_functions.contains(name)) {
+          continue;
+        }
+        if (std::any_of(rhss.begin(), rhss.end(), may_be_injection)) {
+          dirty |= injection_functions.insert(name).second;
+        }
+      }
+    } while (dirty);
+
+    injection_functions_ = std::move(injection_functions);
+  }
+
+  auto decl = symbol_declarations_.find(function_name);
+  if (decl == symbol_declarations_.end()
+      || !decl->second->attributes().contains(attribute_set::key::Function)) {
+    return true;
+  }
+  return injection_functions_->contains(function_name);
+}
+
 // NOLINTNEXTLINE(*-function-cognitive-complexity)
 void kore_definition::preprocess() {
   get_subsorts();
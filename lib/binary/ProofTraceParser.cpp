@@ -7,6 +7,31 @@ namespace kllvm {
 
 constexpr auto indent_size = 2U;
 
+sptr<kore_pattern> llvm_kore_term::get_pattern() const {
+  if (!encoded_) {
+    return pattern_;
+  }
+  if (!encoded_->pattern) {
+    auto const &bytes = encoded_->bytes;
+    proof_trace_memory_buffer buffer(bytes.data(), bytes.data() + bytes.size());
+    uint64_t pattern_len = 0;
+    encoded_->pattern = detail::read_v2(buffer, *encoded_->header, pattern_len);
+  }
+  return encoded_->pattern;
+}
+
+llvm_rewrite_event::substitution_t const &
+llvm_rewrite_event::get_substitution() const {
+  if (!substitution_) {
+    substitution_.emplace();
+    for (auto const &[name, term] : substitution_terms_) {
+      substitution_->insert(std::make_pair(
+          name, std::make_pair(term.get_pattern(), term.get_pattern_length())));
+    }
+  }
+  return *substitution_;
+}
+
 llvm_function_event::llvm_function_event(
     std::string name, std::string relative_position)
     : name_(std::move(name))
@@ -24,8 +49,7 @@ llvm_hook_event::llvm_hook_event(
     std::string name, std::string symbol_name, std::string relative_position)
     : name_(std::move(name))
     , symbol_name_(std::move(symbol_name))
-    , relative_position_(std::move(relative_position))
-    , kore_pattern_(nullptr) { }
+    , relative_position_(std::move(relative_position)) { }
 
 void llvm_hook_event::add_argument(llvm_event const &argument) {
   arguments_.push_back(argument);
@@ -34,13 +58,14 @@ void llvm_hook_event::add_argument(llvm_event const &argument) {
 void llvm_rewrite_event::print_substitution(
     std::ostream &out, bool expand_terms, unsigned ind) const {
   std::string indent(ind * indent_size, ' ');
-  for (auto const &p : substitution_) {
+  for (auto const &[name, term] : substitution_terms_) {
     if (expand_terms) {
-      out << fmt::format("{}{} = kore[", indent, p.first);
-      p.second.first->strip_injections()->print(out);
+      out << fmt::format("{}{} = kore[", indent, name);
+      term.get_pattern()->strip_injections()->print(out);
       out << fmt::format("]\n");
     } else {
-      out << fmt::format("{}{} = kore[{}]\n", indent, p.first, p.second.second);
+      out << fmt::format(
+          "{}{} = kore[{}]\n", indent, name, term.get_pattern_length());
     }
   }
 }
@@ -49,16 +74,23 @@ void llvm_rule_event::print(
     std::ostream &out, bool expand_terms, unsigned ind) const {
   std::string indent(ind * indent_size, ' ');
   out << fmt::format(
-      "{}rule: {} {}\n", indent, get_rule_ordinal(), get_substitution().size());
+      "{}rule: {} {}\n", indent, get_rule_ordinal(),
+      get_substitution_terms().size());
   print_substitution(out, expand_terms, ind + 1U);
 }
 
+void llvm_elided_rule_event::print(
+    std::ostream &out, bool expand_terms, unsigned ind) const {
+  std::string indent(ind * indent_size, ' ');
+  out << fmt::format("{}rule elided: {}\n", indent, rule_ordinal_);
+}
+
 void llvm_side_condition_event::print(
     std::ostream &out, bool expand_terms, unsigned ind) const {
   std::string indent(ind * indent_size, ' ');
   out << fmt::format(
       "{}side condition entry: {} {}\n", indent, get_rule_ordinal(),
-      get_substitution().size());
+      get_substitution_terms().size());
   print_substitution(out, expand_terms, ind + 1U);
 }
 
@@ -90,10 +122,11 @@ void llvm_hook_event::print(
   }
   if (expand_terms) {
     out << fmt::format("{}hook result: kore[", indent);
-    kore_pattern_->strip_injections()->print(out);
+    result_.get_pattern()->strip_injections()->print(out);
     out << fmt::format("]\n");
   } else {
-    out << fmt::format("{}hook result: kore[{}]\n", indent, pattern_length_);
+    out << fmt::format(
+        "{}hook result: kore[{}]\n", indent, result_.get_pattern_length());
   }
 }
 
@@ -105,20 +138,21 @@ void llvm_event::print(
     std::string indent(ind * indent_size, ' ');
     if (expand_terms) {
       out << fmt::format("{}{}: kore[", indent, is_arg ? "arg" : "config");
-      kore_pattern_->strip_injections()->print(out);
+      kore_term_.get_pattern()->strip_injections()->print(out);
       out << fmt::format("]\n");
     } else {
       out << fmt::format(
           "{}{}: kore[{}]\n", indent, is_arg ? "arg" : "config",
-          pattern_length_);
+          kore_term_.get_pattern_length());
     }
   }
 }
 
 llvm_rewrite_trace_iterator::llvm_rewrite_trace_iterator(
-    std::unique_ptr<proof_trace_buffer> buffer, kore_header const &header)
+    std::unique_ptr<proof_trace_buffer> buffer, kore_header const &header,
+    bool lazy)
     : buffer_(std::move(buffer))
-    , parser_(false, false, header) {
+    , parser_(false, false, header, lazy) {
   if (!proof_trace_parser::parse_header(*buffer_, version_)) {
     throw std::runtime_error("invalid header");
   }
@@ -138,13 +172,12 @@ llvm_rewrite_trace_iterator::get_next_event() {
       }
       return {{type_, event}};
     }
-    uint64_t pattern_len = 0;
-    auto config = parser_.parse_config(*buffer_, pattern_len);
-    if (!config) {
+    llvm_kore_term config;
+    if (!parser_.parse_config(*buffer_, config)) {
       throw std::runtime_error("could not parse config event");
     }
     llvm_event config_event;
-    config_event.setkore_pattern(config, pattern_len);
+    config_event.set_kore_term(config);
     type_ = llvm_event_type::Trace;
     return {{llvm_event_type::InitialConfig, config_event}};
   }
@@ -159,6 +192,41 @@ llvm_rewrite_trace_iterator::get_next_event() {
   }
 }
 
+void llvm_rewrite_trace_iterator::visit(llvm_rewrite_trace_visitor &visitor) {
+  visitor.version(version_);
+  while (auto annotated = get_next_event()) {
+    auto type = annotated->type;
+    auto const &event = annotated->event;
+    if (event.is_pattern()) {
+      visitor.config(type, event.get_kore_term());
+      continue;
+    }
+
+    auto const *step = event.get_step_event().get();
+    if (auto const *rule = dynamic_cast<llvm_rule_event const *>(step)) {
+      visitor.rule(type, *rule);
+    } else if (
+        auto const *elided
+        = dynamic_cast<llvm_elided_rule_event const *>(step)) {
+      visitor.elided_rule(type, *elided);
+    } else if (
+        auto const *side
+        = dynamic_cast<llvm_side_condition_event const *>(step)) {
+      visitor.side_condition(type, *side);
+    } else if (
+        auto const *side_end
+        = dynamic_cast<llvm_side_condition_end_event const *>(step)) {
+      visitor.side_condition_end(type, *side_end);
+    } else if (
+        auto const *function
+        = dynamic_cast<llvm_function_event const *>(step)) {
+      visitor.function(type, *function);
+    } else if (auto const *hook = dynamic_cast<llvm_hook_event const *>(step)) {
+      visitor.hook(type, *hook);
+    }
+  }
+}
+
 void llvm_rewrite_trace_iterator::print(
     std::ostream &out, bool expand_terms, unsigned ind) {
   std::string indent(ind * indent_size, ' ');
@@ -182,10 +250,11 @@ void llvm_rewrite_trace::print(
 }
 
 proof_trace_parser::proof_trace_parser(
-    bool verbose, bool expand_terms, kore_header const &header)
+    bool verbose, bool expand_terms, kore_header const &header, bool lazy)
     : verbose_(verbose)
     , expand_terms_(expand_terms)
-    , header_(header) { }
+    , header_(header)
+    , lazy_(lazy) { }
 
 std::optional<llvm_rewrite_trace>
 proof_trace_parser::parse_proof_trace(std::string const &data) {
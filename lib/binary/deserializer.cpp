@@ -158,6 +158,49 @@ sptr<kore_pattern> read_v2(
   }
 }
 
+void read_v2_bytes(
+    proof_trace_buffer &buffer, kore_header const &header, std::string &bytes,
+    uint64_t &pattern_len) {
+  auto append = [&](size_t len) {
+    auto old_size = bytes.size();
+    bytes.resize(old_size + len);
+    if (!buffer.read(bytes.data() + old_size, len)) {
+      throw std::runtime_error("invalid term data");
+    }
+  };
+
+  // Count the terms still to be read rather than recursing, so that deeply
+  // nested terms can be skipped without exhausting the stack.
+  uint64_t remaining = 1;
+  while (remaining > 0) {
+    --remaining;
+    int tag = buffer.read();
+    bytes.push_back(static_cast<char>(tag));
+    switch (tag) {
+    case 0: {
+      uint64_t len = 0;
+      if (!buffer.read_uint64(len)) {
+        throw std::runtime_error("invalid length");
+      }
+      bytes.append(reinterpret_cast<char const *>(&len), sizeof(len));
+      append(len + 1);
+      pattern_len += 2 + sizeof(len) + len;
+      break;
+    }
+    case 1: {
+      uint32_t offset = 0;
+      if (!buffer.read_uint32(offset)) {
+        throw std::runtime_error("invalid offset");
+      }
+      bytes.append(reinterpret_cast<char const *>(&offset), sizeof(offset));
+      remaining += header.get_arity(offset);
+      break;
+    }
+    default: throw std::runtime_error("Bad term");
+    }
+  }
+}
+
 } // namespace detail
 
 } // namespace kllvm
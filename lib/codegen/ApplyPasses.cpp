@@ -15,9 +15,12 @@
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Pass.h>
+#include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/IPO/HotColdSplitting.h>
+#include <llvm/Transforms/IPO/MergeFunctions.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Utils.h>
 
@@ -54,6 +57,35 @@ void apply_kllvm_opt_passes(llvm::Module &mod, bool hidden_visibility) {
   }
 
   pm.run(mod);
+
+  // Blocks that only lead to a call to a cold function, such as abort,
+  // finish_rewriting for a stuck function or add_match_fail_reason, are
+  // outlined into separate functions so that the hot rule code stays
+  // contiguous. Unlike MergeFunctions, the pass queries function analyses
+  // through the analysis manager, so it needs the full set registered.
+  if (hot_cold_split) {
+    auto lam = LoopAnalysisManager();
+    auto fam = FunctionAnalysisManager();
+    auto cgam = CGSCCAnalysisManager();
+    auto mam = ModuleAnalysisManager();
+    auto pb = PassBuilder();
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+    HotColdSplittingPass().run(mod, mam);
+  }
+
+  // Many rules share a side condition or other generated code; identical
+  // functions are folded into one. The pass does not use the analysis manager
+  // it is given, so calling it directly avoids setting up the new pass manager.
+  // It compares functions without their !dbg attachments, so when emitting
+  // debug info we keep every function to preserve its K source location.
+  if (merge_functions && !debug && !debug_line_tables_only) {
+    auto mam = ModuleAnalysisManager();
+    MergeFunctionsPass().run(mod, mam);
+  }
 }
 
 void generate_object_file(llvm::Module &mod, llvm::raw_ostream &os) {
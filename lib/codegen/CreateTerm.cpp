@@ -1,13 +1,17 @@
 #include "kllvm/codegen/CreateTerm.h"
 #include "kllvm/codegen/CreateStaticTerm.h"
 #include "kllvm/codegen/Debug.h"
+#include "kllvm/codegen/Options.h"
 #include "kllvm/codegen/ProofEvent.h"
 #include "kllvm/codegen/Util.h"
 
 #include <fmt/format.h>
+#include <fstream>
 #include <gmp.h>
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <unordered_set>
 
 #include "runtime/header.h" //for macros
 
@@ -322,7 +326,7 @@ llvm::Value *create_term::alloc_arg(
   llvm::Value *ret = create_allocation(p, new_location).first;
   auto *sort = dynamic_cast<kore_composite_sort *>(p->get_sort().get());
   proof_event e(definition_, module_);
-  current_block_ = e.argument(ret, sort, is_hook_arg, current_block_);
+  current_block_ = e.argument(ret, pattern, sort, is_hook_arg, current_block_);
   return ret;
 }
 
@@ -336,6 +340,88 @@ std::string escape(std::string const &str) {
   return os.str();
 }
 
+namespace {
+
+// Int expressions reduced modulo 2^N, or bit-ranged to N bits, are evaluated
+// as N-bit machine integers when N is at most this.
+constexpr unsigned max_fixed_width_bits = 256;
+
+std::optional<llvm::APInt> int_literal(kore_pattern *pattern) {
+  auto *dv = dynamic_cast<kore_composite_pattern *>(pattern);
+  if (!dv || dv->get_constructor()->get_name() != "\\dv") {
+    return std::nullopt;
+  }
+  auto *str = dynamic_cast<kore_string_pattern *>(dv->get_arguments()[0].get());
+  std::string const &contents = str->get_contents();
+  // Four bits per decimal digit, plus a sign bit, always suffice.
+  return llvm::APInt(contents.size() * 4 + 1, contents, 10);
+}
+
+// Returns the value of a non-negative Int literal that fits in 64 bits.
+std::optional<uint64_t> small_int_literal(kore_pattern *pattern) {
+  auto literal = int_literal(pattern);
+  if (!literal || literal->isNegative() || literal->getActiveBits() > 64) {
+    return std::nullopt;
+  }
+  return literal->getZExtValue();
+}
+
+// Returns N if pattern is the Int literal 2^N.
+std::optional<uint64_t> power_of_two_literal(kore_pattern *pattern) {
+  auto literal = int_literal(pattern);
+  if (!literal || literal->isNegative() || !literal->isPowerOf2()) {
+    return std::nullopt;
+  }
+  return literal->logBase2();
+}
+
+std::string hook_name(kore_pattern *pattern, kore_definition *definition) {
+  auto *app = dynamic_cast<kore_composite_pattern *>(pattern);
+  if (!app) {
+    return "";
+  }
+  auto const &decls = definition->get_symbol_declarations();
+  auto decl = decls.find(app->get_constructor()->get_name());
+  if (decl == decls.end()
+      || !decl->second->attributes().contains(attribute_set::key::Hook)) {
+    return "";
+  }
+  auto *str = dynamic_cast<kore_string_pattern *>(
+      decl->second->attributes()
+          .get(attribute_set::key::Hook)
+          ->get_arguments()[0]
+          .get());
+  return str->get_contents();
+}
+
+std::optional<llvm::Instruction::BinaryOps>
+word_binary_operation(std::string const &hook) {
+  static std::map<std::string, llvm::Instruction::BinaryOps> const ops = {
+      {"INT.add", llvm::Instruction::Add}, {"INT.sub", llvm::Instruction::Sub},
+      {"INT.mul", llvm::Instruction::Mul}, {"INT.and", llvm::Instruction::And},
+      {"INT.or", llvm::Instruction::Or},   {"INT.xor", llvm::Instruction::Xor},
+  };
+  auto op = ops.find(hook);
+  if (op == ops.end()) {
+    return std::nullopt;
+  }
+  return op->second;
+}
+
+// The low bits of the result of these operations only depend on the low bits
+// of their arguments.
+bool is_word_operation(std::string const &hook) {
+  return word_binary_operation(hook) || hook == "INT.not" || hook == "INT.neg"
+         || hook == "INT.shl" || hook == "INT.emod" || hook == "INT.bitRange"
+         || hook == "INT.signExtendBitRange";
+}
+
+unsigned round_up_to_words(uint64_t bits) {
+  return (bits + 63) / 64 * 64;
+}
+
+} // namespace
+
 // NOLINTNEXTLINE(*-cognitive-complexity)
 llvm::Value *create_term::create_hook(
     kore_composite_pattern *hook_att, kore_composite_pattern *pattern,
@@ -432,6 +518,18 @@ llvm::Value *create_term::create_hook(
         "hook_BOOL_eq");
     return eq;
   }
+  if ((name == "KEQUAL.eq" || name == "KEQUAL.ne")
+      && !proof_hint_instrumentation) {
+    assert(pattern->get_arguments().size() == 2);
+    llvm::Value *eq = create_equality(pattern, location_stack);
+    if (name == "KEQUAL.ne") {
+      return llvm::BinaryOperator::Create(
+          llvm::Instruction::Xor, eq,
+          llvm::ConstantInt::get(llvm::Type::getInt1Ty(ctx_), 1),
+          "hook_KEQUAL_ne", current_block_);
+    }
+    return eq;
+  }
   if (name == "KEQUAL.ite") {
     assert(pattern->get_arguments().size() == 3);
     llvm::Value *cond = alloc_arg(pattern, 0, true, location_stack);
@@ -673,6 +771,13 @@ llvm::Value *create_term::create_hook(
     assert(false && "not implemented yet: MInt");
     abort();
   }
+  if ((name == "INT.emod" || name == "INT.bitRange"
+       || name == "INT.signExtendBitRange")
+      && !proof_hint_instrumentation) {
+    if (auto *result = create_fixed_width_int(name, pattern, location_stack)) {
+      return result;
+    }
+  }
   std::string hook_name = "hook_" + name.substr(0, name.find('.')) + "_"
                           + name.substr(name.find('.') + 1);
   auto *old_val = disable_gc();
@@ -700,6 +805,560 @@ void create_term::enable_gc(llvm::Value *was_enabled) {
   new llvm::StoreInst(was_enabled, global_var, current_block_);
 }
 
+// STRING.concat may return a rope rather than a flat string. Only the hooks
+// below understand ropes; every other hook is passed flattened strings so that
+// it can keep reading the contents of its String arguments directly.
+static bool is_rope_aware_hook(std::string const &name) {
+  return name == "hook_STRING_concat" || name == "hook_STRING_length";
+}
+
+static bool
+is_string_sort(kore_composite_sort *sort, kore_definition *definition) {
+  auto const &att
+      = definition->get_sort_declarations().at(sort->get_name())->attributes();
+  return att.contains(attribute_set::key::Hook)
+         && sort->get_hook(definition) == "STRING.String";
+}
+
+llvm::Value *create_kequal_eq(
+    llvm::Value *lhs, llvm::Value *rhs, llvm::BasicBlock *&block,
+    llvm::Module *module) {
+  auto &ctx = module->getContext();
+  auto *i64 = llvm::Type::getInt64Ty(ctx);
+  auto *entry_block = block;
+  auto *same = new llvm::ICmpInst(
+      *entry_block, llvm::CmpInst::ICMP_EQ, lhs, rhs, "same");
+  auto *lhs_int = new llvm::PtrToIntInst(lhs, i64, "", entry_block);
+  auto *rhs_int = new llvm::PtrToIntInst(rhs, i64, "", entry_block);
+  auto *either = llvm::BinaryOperator::Create(
+      llvm::Instruction::Or, lhs_int, rhs_int, "", entry_block);
+  auto *leaf_bit = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, either, llvm::ConstantInt::get(i64, 1), "",
+      entry_block);
+  auto *has_leaf = new llvm::ICmpInst(
+      *entry_block, llvm::CmpInst::ICMP_NE, leaf_bit,
+      llvm::ConstantInt::get(i64, 0), "has_leaf");
+  auto *decided = llvm::BinaryOperator::Create(
+      llvm::Instruction::Or, same, has_leaf, "decided", entry_block);
+
+  auto *call_block
+      = llvm::BasicBlock::Create(ctx, "kequal_call", entry_block->getParent());
+  auto *merge_block = llvm::BasicBlock::Create(
+      ctx, "hook_KEQUAL_eq", entry_block->getParent());
+  llvm::BranchInst::Create(merge_block, call_block, decided, entry_block);
+
+  auto *call = llvm::CallInst::Create(
+      get_or_insert_function(
+          module, "hook_KEQUAL_eq", llvm::Type::getInt1Ty(ctx),
+          lhs->getType(), rhs->getType()),
+      {lhs, rhs}, "", call_block);
+  set_debug_loc(call);
+  llvm::BranchInst::Create(merge_block, call_block);
+
+  // Pointer-equal terms are equal, and a constant constructor is only ever
+  // equal to itself, so the runtime is only consulted for distinct blocks.
+  auto *phi = llvm::PHINode::Create(
+      llvm::Type::getInt1Ty(ctx), 2, "phi", merge_block);
+  phi->addIncoming(same, entry_block);
+  phi->addIncoming(call, call_block);
+  block = merge_block;
+  return phi;
+}
+
+// Splits an ==K comparison into comparisons of corresponding subterms wherever
+// both sides are built by the same constructor: such blocks share a header and
+// layout, so they are equal exactly when their children are. Returns false if
+// some pair of subterms has a category that cannot be compared inline.
+bool create_term::split_equality(
+    kore_pattern *lhs, kore_pattern *rhs,
+    std::vector<std::pair<kore_pattern *, kore_pattern *>> &operands) {
+  auto *lhs_var = dynamic_cast<kore_variable_pattern *>(lhs);
+  auto *rhs_var = dynamic_cast<kore_variable_pattern *>(rhs);
+  auto *sort = dynamic_cast<kore_composite_sort *>(term_sort(lhs).get());
+  auto cat = sort->get_category(definition_).cat;
+  if (lhs_var && rhs_var && lhs_var->get_name() == rhs_var->get_name()
+      && cat != sort_category::Float) {
+    return true;
+  }
+
+  auto *lhs_app = dynamic_cast<kore_composite_pattern *>(lhs);
+  auto *rhs_app = dynamic_cast<kore_composite_pattern *>(rhs);
+  if (lhs_app && rhs_app && cat == sort_category::Symbol
+      && *lhs_app->get_constructor() == *rhs_app->get_constructor()
+      && lhs_app->get_constructor()->get_name() != "\\dv") {
+    auto const *symbol = lhs_app->get_constructor();
+    auto const &att = definition_->get_symbol_declarations()
+                          .at(symbol->get_name())
+                          ->attributes();
+    bool is_constructor = !att.contains(attribute_set::key::Function)
+                          && !att.contains(attribute_set::key::Anywhere)
+                          && !att.contains(attribute_set::key::Hook)
+                          && !att.contains(attribute_set::key::Binder);
+    // An injection of a Symbol-sorted term may be collapsed into the
+    // injection its child already is, so its header is not known statically.
+    if (att.contains(attribute_set::key::SortInjection)) {
+      auto *child_sort = dynamic_cast<kore_composite_sort *>(
+          symbol->get_arguments()[0].get());
+      is_constructor
+          = is_constructor
+            && (child_sort->get_category(definition_).cat
+                    != sort_category::Symbol
+                || is_string_sort(child_sort, definition_));
+    }
+    if (is_constructor) {
+      for (size_t i = 0; i < lhs_app->get_arguments().size(); ++i) {
+        if (!split_equality(
+                lhs_app->get_arguments()[i].get(),
+                rhs_app->get_arguments()[i].get(), operands)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
+  switch (cat) {
+  case sort_category::StringBuffer:
+  case sort_category::MapIter:
+  case sort_category::SetIter:
+  case sort_category::Uncomputed: return false;
+  default: operands.emplace_back(lhs, rhs); return true;
+  }
+}
+
+// Emits the comparison of two flat-or-rope strings that hook_KEQUAL_eq would
+// perform, with the header check and memcmp inline.
+llvm::Value *
+create_term::create_string_equality(llvm::Value *lhs, llvm::Value *rhs) {
+  auto *i64 = llvm::Type::getInt64Ty(ctx_);
+  auto *flatten = get_or_insert_function(
+      module_, "flatten_string", lhs->getType(), lhs->getType());
+  auto *lhs_flat
+      = llvm::CallInst::Create(flatten, {lhs}, "flat", current_block_);
+  set_debug_loc(lhs_flat);
+  auto *rhs_flat
+      = llvm::CallInst::Create(flatten, {rhs}, "flat", current_block_);
+  set_debug_loc(rhs_flat);
+
+  auto *entry_block = current_block_;
+  auto *same = new llvm::ICmpInst(
+      *entry_block, llvm::CmpInst::ICMP_EQ, lhs_flat, rhs_flat, "same");
+  auto *lhs_int = new llvm::PtrToIntInst(lhs_flat, i64, "", entry_block);
+  auto *rhs_int = new llvm::PtrToIntInst(rhs_flat, i64, "", entry_block);
+  auto *either = llvm::BinaryOperator::Create(
+      llvm::Instruction::Or, lhs_int, rhs_int, "", entry_block);
+  auto *leaf_bit = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, either, llvm::ConstantInt::get(i64, 1), "",
+      entry_block);
+  auto *has_leaf = new llvm::ICmpInst(
+      *entry_block, llvm::CmpInst::ICMP_NE, leaf_bit,
+      llvm::ConstantInt::get(i64, 0), "has_leaf");
+  auto *decided = llvm::BinaryOperator::Create(
+      llvm::Instruction::Or, same, has_leaf, "decided", entry_block);
+
+  auto *header_block = llvm::BasicBlock::Create(
+      ctx_, "string_header", entry_block->getParent());
+  auto *data_block = llvm::BasicBlock::Create(
+      ctx_, "string_data", entry_block->getParent());
+  auto *merge_block = llvm::BasicBlock::Create(
+      ctx_, "hook_STRING_eq", entry_block->getParent());
+  llvm::BranchInst::Create(merge_block, header_block, decided, entry_block);
+
+  // Equal canonical headers imply equal lengths; symbolic variables are only
+  // equal to themselves. HDR_MASK clears VARIABLE_BIT, so it is tested on both
+  // headers.
+  auto *lhs_hdr = new llvm::LoadInst(i64, lhs_flat, "lhs_hdr", header_block);
+  auto *rhs_hdr = new llvm::LoadInst(i64, rhs_flat, "rhs_hdr", header_block);
+  auto *hdr_mask = llvm::ConstantInt::get(i64, HDR_MASK);
+  auto *lhs_canon = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, lhs_hdr, hdr_mask, "", header_block);
+  auto *rhs_canon = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, rhs_hdr, hdr_mask, "", header_block);
+  auto *same_hdr = new llvm::ICmpInst(
+      *header_block, llvm::CmpInst::ICMP_EQ, lhs_canon, rhs_canon, "same_hdr");
+  auto *either_hdr = llvm::BinaryOperator::Create(
+      llvm::Instruction::Or, lhs_hdr, rhs_hdr, "", header_block);
+  auto *var_bit = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, either_hdr,
+      llvm::ConstantInt::get(i64, VARIABLE_BIT), "", header_block);
+  auto *not_var = new llvm::ICmpInst(
+      *header_block, llvm::CmpInst::ICMP_EQ, var_bit,
+      llvm::ConstantInt::get(i64, 0), "not_var");
+  auto *compare_data = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, same_hdr, not_var, "", header_block);
+  llvm::BranchInst::Create(data_block, merge_block, compare_data, header_block);
+
+  auto *length = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, lhs_hdr, llvm::ConstantInt::get(i64, LENGTH_MASK),
+      "len", data_block);
+  auto *header_size = llvm::ConstantInt::get(i64, sizeof(blockheader));
+  auto *lhs_data = llvm::GetElementPtrInst::CreateInBounds(
+      llvm::Type::getInt8Ty(ctx_), lhs_flat, {header_size}, "", data_block);
+  auto *rhs_data = llvm::GetElementPtrInst::CreateInBounds(
+      llvm::Type::getInt8Ty(ctx_), rhs_flat, {header_size}, "", data_block);
+  auto *memcmp = llvm::CallInst::Create(
+      get_or_insert_function(
+          module_, "memcmp", llvm::Type::getInt32Ty(ctx_), lhs_data->getType(),
+          rhs_data->getType(), i64),
+      {lhs_data, rhs_data, length}, "", data_block);
+  set_debug_loc(memcmp);
+  auto *same_data = new llvm::ICmpInst(
+      *data_block, llvm::CmpInst::ICMP_EQ, memcmp,
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0), "same_data");
+  llvm::BranchInst::Create(merge_block, data_block);
+
+  auto *phi = llvm::PHINode::Create(
+      llvm::Type::getInt1Ty(ctx_), 3, "phi", merge_block);
+  phi->addIncoming(same, entry_block);
+  phi->addIncoming(llvm::ConstantInt::getFalse(ctx_), header_block);
+  phi->addIncoming(same_data, data_block);
+  current_block_ = merge_block;
+  return phi;
+}
+
+// Compares two values of the sort of the specified pattern, calling the
+// equality of that sort directly rather than dispatching on layouts at run
+// time.
+llvm::Value *create_term::create_value_equality(
+    kore_pattern *pattern, llvm::Value *lhs, llvm::Value *rhs) {
+  auto *sort = dynamic_cast<kore_composite_sort *>(term_sort(pattern).get());
+  auto cat = sort->get_category(definition_);
+  auto *bool_type = llvm::Type::getInt1Ty(ctx_);
+  std::string collection_eq;
+  switch (cat.cat) {
+  case sort_category::Bool:
+  case sort_category::MInt:
+    return new llvm::ICmpInst(
+        *current_block_, llvm::CmpInst::ICMP_EQ, lhs, rhs, "eq");
+  case sort_category::Int: {
+    auto *cmp = llvm::CallInst::Create(
+        get_or_insert_function(
+            module_, "__gmpz_cmp", llvm::Type::getInt32Ty(ctx_),
+            lhs->getType(), rhs->getType()),
+        {lhs, rhs}, "", current_block_);
+    set_debug_loc(cmp);
+    return new llvm::ICmpInst(
+        *current_block_, llvm::CmpInst::ICMP_EQ, cmp,
+        llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0), "eq");
+  }
+  case sort_category::Float: {
+    auto *eq = llvm::CallInst::Create(
+        get_or_insert_function(
+            module_, "hook_FLOAT_trueeq", bool_type, lhs->getType(),
+            rhs->getType()),
+        {lhs, rhs}, "eq", current_block_);
+    set_debug_loc(eq);
+    return eq;
+  }
+  case sort_category::Variable: {
+    auto *eq = llvm::CallInst::Create(
+        get_or_insert_function(
+            module_, "hook_STRING_eq", bool_type, lhs->getType(),
+            rhs->getType()),
+        {lhs, rhs}, "eq", current_block_);
+    set_debug_loc(eq);
+    return eq;
+  }
+  case sort_category::Symbol:
+    if (is_string_sort(sort, definition_)) {
+      return create_string_equality(lhs, rhs);
+    }
+    return create_kequal_eq(lhs, rhs, current_block_, module_);
+  case sort_category::Map: collection_eq = "hook_MAP_eq"; break;
+  case sort_category::RangeMap: collection_eq = "hook_RANGEMAP_eq"; break;
+  case sort_category::List: collection_eq = "hook_LIST_eq"; break;
+  case sort_category::Set: collection_eq = "hook_SET_eq"; break;
+  case sort_category::StringBuffer:
+  case sort_category::MapIter:
+  case sort_category::SetIter:
+  case sort_category::Uncomputed: abort();
+  }
+
+  std::vector<llvm::Value *> args;
+  for (auto *arg : {lhs, rhs}) {
+    if (!arg->getType()->isPointerTy()) {
+      auto *alloc_collection
+          = new llvm::AllocaInst(arg->getType(), 0, "", current_block_);
+      new llvm::StoreInst(arg, alloc_collection, current_block_);
+      arg = alloc_collection;
+    }
+    args.push_back(arg);
+  }
+  auto *eq = llvm::CallInst::Create(
+      get_or_insert_function(
+          module_, collection_eq, bool_type, args[0]->getType(),
+          args[1]->getType()),
+      args, "eq", current_block_);
+  set_debug_loc(eq);
+  return eq;
+}
+
+// Emits ==K between the two arguments of the specified pattern. The arguments
+// are split structurally where their shapes are known statically, and each
+// remaining pair of subterms is compared with the equality of its sort; the
+// comparison stops at the first pair found to differ.
+llvm::Value *create_term::create_equality(
+    kore_composite_pattern *pattern, std::string const &location_stack) {
+  kore_pattern *lhs = pattern->get_arguments()[0].get();
+  kore_pattern *rhs = pattern->get_arguments()[1].get();
+  std::vector<std::pair<kore_pattern *, kore_pattern *>> operands;
+  if (!split_equality(lhs, rhs, operands)) {
+    operands = {{lhs, rhs}};
+  }
+
+  auto location = [&](int idx) {
+    return location_stack.empty() ? fmt::format("{}", idx)
+                                  : fmt::format("{}:{}", location_stack, idx);
+  };
+
+  auto *old_val = disable_gc();
+  std::vector<llvm::Value *> lhs_vals;
+  std::vector<llvm::Value *> rhs_vals;
+  for (auto [lhs_op, rhs_op] : operands) {
+    lhs_vals.push_back(create_allocation(lhs_op, location(0)).first);
+  }
+  for (auto [lhs_op, rhs_op] : operands) {
+    rhs_vals.push_back(create_allocation(rhs_op, location(1)).first);
+  }
+
+  llvm::Value *result = llvm::ConstantInt::getTrue(ctx_);
+  if (!operands.empty()) {
+    auto *merge_block = llvm::BasicBlock::Create(
+        ctx_, "hook_KEQUAL_eq", current_block_->getParent());
+    auto *phi = llvm::PHINode::Create(
+        llvm::Type::getInt1Ty(ctx_), operands.size(), "phi", merge_block);
+    for (size_t i = 0; i < operands.size(); ++i) {
+      llvm::Value *eq
+          = create_value_equality(operands[i].first, lhs_vals[i], rhs_vals[i]);
+      if (i + 1 == operands.size()) {
+        llvm::BranchInst::Create(merge_block, current_block_);
+        phi->addIncoming(eq, current_block_);
+      } else {
+        auto *next_block = llvm::BasicBlock::Create(
+            ctx_, "kequal_next", current_block_->getParent());
+        llvm::BranchInst::Create(next_block, merge_block, eq, current_block_);
+        phi->addIncoming(llvm::ConstantInt::getFalse(ctx_), current_block_);
+        current_block_ = next_block;
+      }
+    }
+    current_block_ = merge_block;
+    result = phi;
+  }
+  enable_gc(old_val);
+  return result;
+}
+
+// Emits `X modInt 2^N`, `bitRangeInt(X, OFF, LEN)` and
+// `signExtendBitRangeInt(X, OFF, LEN)` with constant N, OFF and LEN as
+// arithmetic on machine integers of at most max_fixed_width_bits bits, when X
+// is itself an arithmetic expression. Only the operands of X that are not
+// arithmetic are computed with GMP, and only the final result is boxed.
+// Returns nullptr if the expression does not have this shape.
+llvm::Value *create_term::create_fixed_width_int(
+    std::string const &name, kore_composite_pattern *pattern,
+    std::string const &location_stack) {
+  kore_pattern *arg = pattern->get_arguments()[0].get();
+  if (static_terms_.contains(arg) || hoisted_calls_.contains(arg)
+      || !is_word_operation(hook_name(arg, definition_))) {
+    return nullptr;
+  }
+
+  if (name == "INT.emod") {
+    auto bits = power_of_two_literal(pattern->get_arguments()[1].get());
+    if (!bits || *bits == 0 || *bits > max_fixed_width_bits) {
+      return nullptr;
+    }
+    unsigned width = round_up_to_words(*bits);
+    llvm::Value *word = create_word_arg(pattern, 0, width, location_stack);
+    word = llvm::BinaryOperator::Create(
+        llvm::Instruction::And, word,
+        llvm::ConstantInt::get(ctx_, llvm::APInt::getLowBitsSet(width, *bits)),
+        "mod", current_block_);
+    return create_int_from_word(word, false);
+  }
+
+  auto off = small_int_literal(pattern->get_arguments()[1].get());
+  auto len = small_int_literal(pattern->get_arguments()[2].get());
+  if (!off || !len || *len == 0 || *off > max_fixed_width_bits
+      || *off + *len > max_fixed_width_bits) {
+    return nullptr;
+  }
+  unsigned width = round_up_to_words(*off + *len);
+  auto *type = llvm::IntegerType::get(ctx_, width);
+  llvm::Value *word = create_word_arg(pattern, 0, width, location_stack);
+  if (name == "INT.bitRange") {
+    word = llvm::BinaryOperator::Create(
+        llvm::Instruction::LShr, word, llvm::ConstantInt::get(type, *off),
+        "range", current_block_);
+    word = llvm::BinaryOperator::Create(
+        llvm::Instruction::And, word,
+        llvm::ConstantInt::get(ctx_, llvm::APInt::getLowBitsSet(width, *len)),
+        "range", current_block_);
+    return create_int_from_word(word, false);
+  }
+  word = llvm::BinaryOperator::Create(
+      llvm::Instruction::Shl, word,
+      llvm::ConstantInt::get(type, width - *off - *len), "range",
+      current_block_);
+  word = llvm::BinaryOperator::Create(
+      llvm::Instruction::AShr, word, llvm::ConstantInt::get(type, width - *len),
+      "range", current_block_);
+  return create_int_from_word(word, true);
+}
+
+// Emits the value of the idx-th argument of pattern modulo 2^width, where
+// width is a multiple of 64.
+// NOLINTNEXTLINE(*-cognitive-complexity)
+llvm::Value *create_term::create_word_arg(
+    kore_composite_pattern *pattern, int idx, unsigned width,
+    std::string const &location_stack) {
+  auto *type = llvm::IntegerType::get(ctx_, width);
+  kore_pattern *arg = pattern->get_arguments()[idx].get();
+  if (auto literal = int_literal(arg)) {
+    return llvm::ConstantInt::get(type, literal->sextOrTrunc(width));
+  }
+
+  std::string new_location = location_stack.empty()
+                                 ? fmt::format("{}", idx)
+                                 : fmt::format("{}:{}", location_stack, idx);
+  auto *app = dynamic_cast<kore_composite_pattern *>(arg);
+  std::string hook = static_terms_.contains(arg) || hoisted_calls_.contains(arg)
+                         ? ""
+                         : hook_name(arg, definition_);
+
+  if (auto op = word_binary_operation(hook)) {
+    llvm::Value *first = create_word_arg(app, 0, width, new_location);
+    llvm::Value *second = create_word_arg(app, 1, width, new_location);
+    return llvm::BinaryOperator::Create(
+        *op, first, second, "word", current_block_);
+  }
+  if (hook == "INT.not") {
+    llvm::Value *in = create_word_arg(app, 0, width, new_location);
+    return llvm::BinaryOperator::CreateNot(in, "word", current_block_);
+  }
+  if (hook == "INT.neg") {
+    llvm::Value *in = create_word_arg(app, 0, width, new_location);
+    return llvm::BinaryOperator::CreateNeg(in, "word", current_block_);
+  }
+  if (hook == "INT.shl") {
+    if (auto shift = small_int_literal(app->get_arguments()[1].get())) {
+      llvm::Value *in = create_word_arg(app, 0, width, new_location);
+      if (*shift >= width) {
+        return llvm::ConstantInt::get(type, 0);
+      }
+      return llvm::BinaryOperator::Create(
+          llvm::Instruction::Shl, in, llvm::ConstantInt::get(type, *shift),
+          "word", current_block_);
+    }
+  }
+  if (hook == "INT.emod") {
+    if (auto bits = power_of_two_literal(app->get_arguments()[1].get())) {
+      llvm::Value *in = create_word_arg(app, 0, width, new_location);
+      if (*bits >= width) {
+        return in;
+      }
+      return llvm::BinaryOperator::Create(
+          llvm::Instruction::And, in,
+          llvm::ConstantInt::get(
+              ctx_, llvm::APInt::getLowBitsSet(width, *bits)),
+          "word", current_block_);
+    }
+  }
+  if (hook == "INT.bitRange" || hook == "INT.signExtendBitRange") {
+    auto off = small_int_literal(app->get_arguments()[1].get());
+    auto len = small_int_literal(app->get_arguments()[2].get());
+    if (off && len && *len > 0 && *off <= width && *off + *len <= width) {
+      llvm::Value *in = create_word_arg(app, 0, width, new_location);
+      if (hook == "INT.bitRange") {
+        in = llvm::BinaryOperator::Create(
+            llvm::Instruction::LShr, in, llvm::ConstantInt::get(type, *off),
+            "word", current_block_);
+        return llvm::BinaryOperator::Create(
+            llvm::Instruction::And, in,
+            llvm::ConstantInt::get(
+                ctx_, llvm::APInt::getLowBitsSet(width, *len)),
+            "word", current_block_);
+      }
+      in = llvm::BinaryOperator::Create(
+          llvm::Instruction::Shl, in,
+          llvm::ConstantInt::get(type, width - *off - *len), "word",
+          current_block_);
+      return llvm::BinaryOperator::Create(
+          llvm::Instruction::AShr, in,
+          llvm::ConstantInt::get(type, width - *len), "word", current_block_);
+    }
+  }
+
+  // Any other operand is computed as usual and its low words read back.
+  llvm::Value *mpz = alloc_arg(pattern, idx, true, location_stack);
+  size_t nwords = width / 64;
+  auto *i64_ty = llvm::Type::getInt64Ty(ctx_);
+  auto *buffer = create_words_buffer(width);
+  auto *call = llvm::CallInst::Create(
+      get_or_insert_function(
+          module_, "int_low_words", llvm::Type::getVoidTy(ctx_),
+          getvalue_type({sort_category::Int, 0}, module_),
+          llvm::PointerType::getUnqual(ctx_), i64_ty),
+      {mpz, buffer, llvm::ConstantInt::get(i64_ty, nwords)}, "",
+      current_block_);
+  set_debug_loc(call);
+  llvm::Value *result = llvm::ConstantInt::get(type, 0);
+  for (size_t i = 0; i < nwords; i++) {
+    auto *ptr = llvm::GetElementPtrInst::Create(
+        i64_ty, buffer, {llvm::ConstantInt::get(i64_ty, i)}, "ptr",
+        current_block_);
+    auto *word = new llvm::LoadInst(i64_ty, ptr, "word", current_block_);
+    auto *zext = new llvm::ZExtInst(word, type, "extended", current_block_);
+    auto *shl = llvm::BinaryOperator::Create(
+        llvm::Instruction::Shl, zext, llvm::ConstantInt::get(type, i * 64),
+        "shift", current_block_);
+    result = llvm::BinaryOperator::Create(
+        llvm::Instruction::Or, result, shl, "or", current_block_);
+  }
+  return result;
+}
+
+// Allocates a buffer of width / 64 words in the entry block of the current
+// function, so that it is reused if the function loops.
+llvm::Value *create_term::create_words_buffer(unsigned width) {
+  auto *type = llvm::ArrayType::get(llvm::Type::getInt64Ty(ctx_), width / 64);
+  auto &entry = current_block_->getParent()->getEntryBlock();
+  if (auto *first = entry.getFirstNonPHI()) {
+    return new llvm::AllocaInst(type, 0, "words", first);
+  }
+  return new llvm::AllocaInst(type, 0, "words", &entry);
+}
+
+llvm::Value *
+create_term::create_int_from_word(llvm::Value *word, bool is_signed) {
+  unsigned width = word->getType()->getIntegerBitWidth();
+  size_t nwords = width / 64;
+  auto *i64_ty = llvm::Type::getInt64Ty(ctx_);
+  auto *buffer = create_words_buffer(width);
+  for (size_t i = 0; i < nwords; i++) {
+    auto *ptr = llvm::GetElementPtrInst::Create(
+        i64_ty, buffer, {llvm::ConstantInt::get(i64_ty, i)}, "ptr",
+        current_block_);
+    auto *shifted = llvm::BinaryOperator::Create(
+        llvm::Instruction::LShr, word,
+        llvm::ConstantInt::get(word->getType(), i * 64), "shift",
+        current_block_);
+    auto *trunc = new llvm::TruncInst(shifted, i64_ty, "word", current_block_);
+    new llvm::StoreInst(trunc, ptr, current_block_);
+  }
+  auto *result = llvm::CallInst::Create(
+      get_or_insert_function(
+          module_, "hook_MINT_import",
+          getvalue_type({sort_category::Int, 0}, module_),
+          llvm::PointerType::getUnqual(ctx_), i64_ty,
+          llvm::Type::getInt1Ty(ctx_)),
+      {buffer, llvm::ConstantInt::get(i64_ty, width),
+       llvm::ConstantInt::getBool(ctx_, is_signed)},
+      "hook_INT_fixed_width", current_block_);
+  set_debug_loc(result);
+  return result;
+}
+
 // We use tailcc calling convention for apply_rule_* and eval_* functions to
 // make these K functions tail recursive when their K definitions are tail
 // recursive.
@@ -720,6 +1379,15 @@ llvm::Value *create_term::create_function_call(
     auto *concrete_sort = dynamic_cast<kore_composite_sort *>(sort.get());
     llvm::Value *arg = alloc_arg(pattern, i, false, location_stack);
     i++;
+    if (is_hook && !is_rope_aware_hook(name)
+        && is_string_sort(concrete_sort, definition_)) {
+      auto *flatten = llvm::CallInst::Create(
+          get_or_insert_function(
+              module_, "flatten_string", arg->getType(), arg->getType()),
+          {arg}, "flat", current_block_);
+      set_debug_loc(flatten);
+      arg = flatten;
+    }
     switch (concrete_sort->get_category(definition_).cat) {
     case sort_category::Map:
     case sort_category::RangeMap:
@@ -739,14 +1407,15 @@ llvm::Value *create_term::create_function_call(
     }
   }
 
-  current_block_ = event.function_event_post(current_block_);
+  current_block_ = event.function_event_post(current_block_, pattern);
 
   if (is_hook) {
     int i = 0;
     for (auto const &p : pattern->get_arguments()) {
       auto *sort = dynamic_cast<kore_composite_sort *>(p->get_sort().get());
       proof_event e(definition_, module_);
-      current_block_ = e.argument(args[i], sort, true, current_block_);
+      current_block_
+          = e.argument(args[i], pattern, sort, true, current_block_);
       i++;
     }
   }
@@ -806,6 +1475,46 @@ llvm::Value *create_term::create_function_call(
   return call;
 }
 
+// Returns the tags of the symbols that the profile given with
+// --pretenure-profile found to survive into the old generation at least as
+// often as --pretenure-threshold. Each line of the profile, as written by a
+// run with KLLVM_PRETENURE_PROFILE set, names a symbol followed by the number
+// of its terms that were allocated and promoted.
+static std::unordered_set<uint32_t> const &
+get_pretenured_tags(kore_definition *definition) {
+  static std::optional<std::unordered_set<uint32_t>> tags;
+  if (tags) {
+    return *tags;
+  }
+  tags.emplace();
+  if (pretenure_profile.empty()) {
+    return *tags;
+  }
+  std::ifstream profile(pretenure_profile);
+  if (!profile) {
+    throw std::runtime_error(fmt::format(
+        "Could not open pretenuring profile {}", pretenure_profile.getValue()));
+  }
+  std::string line;
+  while (std::getline(profile, line)) {
+    auto promotions_pos = line.rfind(' ');
+    auto allocations_pos = line.rfind(' ', promotions_pos - 1);
+    if (promotions_pos == std::string::npos
+        || allocations_pos == std::string::npos) {
+      continue;
+    }
+    auto name = line.substr(0, allocations_pos);
+    auto allocations = std::stoull(line.substr(allocations_pos + 1));
+    auto promotions = std::stoull(line.substr(promotions_pos + 1));
+    auto const &symbols = definition->get_all_symbols();
+    if (allocations && promotions >= pretenure_threshold * allocations
+        && symbols.contains(name)) {
+      tags->insert(symbols.at(name)->get_tag());
+    }
+  }
+  return *tags;
+}
+
 /* create a term, given the assumption that the created term will not be a
  * triangle injection pair */
 llvm::Value *create_term::not_injection_case(
@@ -850,13 +1559,32 @@ llvm::Value *create_term::not_injection_case(
     children.push_back(child_value);
     idx++;
   }
-  llvm::Value *block = allocate_term(block_type, current_block_);
-  llvm::Value *block_header_ptr = llvm::GetElementPtrInst::CreateInBounds(
-      block_type, block,
-      {llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), 0),
-       llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0)},
-      symbol->get_name(), current_block_);
-  new llvm::StoreInst(block_header, block_header_ptr, current_block_);
+  llvm::Value *block = nullptr;
+  if (pretenure_online
+      || get_pretenured_tags(definition_).contains(symbol->get_tag())) {
+    // The runtime writes the header of the block itself, as only it knows
+    // which generation the block ends up in.
+    auto *i64 = llvm::Type::getInt64Ty(ctx_);
+    auto *alloc = llvm::CallInst::Create(
+        get_or_insert_function(
+            module_,
+            pretenure_online ? "kore_alloc_adaptive" : "kore_alloc_pretenured",
+            llvm::PointerType::getUnqual(ctx_), i64, i64),
+        {llvm::ConstantExpr::getSizeOf(block_type),
+         llvm::ConstantInt::get(
+             i64, get_block_header_val(module_, symbol, block_type))},
+        "", current_block_);
+    set_debug_loc(alloc);
+    block = alloc;
+  } else {
+    block = allocate_term(block_type, current_block_);
+    llvm::Value *block_header_ptr = llvm::GetElementPtrInst::CreateInBounds(
+        block_type, block,
+        {llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), 0),
+         llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0)},
+        symbol->get_name(), current_block_);
+    new llvm::StoreInst(block_header, block_header_ptr, current_block_);
+  }
   idx = 2;
   for (auto &child_value : children) {
     llvm::Value *child_ptr = llvm::GetElementPtrInst::CreateInBounds(
@@ -884,6 +1612,10 @@ llvm::Value *create_term::not_injection_case(
 // injection
 std::pair<llvm::Value *, bool> create_term::operator()(kore_pattern *pattern) {
   populate_static_set(pattern);
+  // Hoisting would elide the events that proof hints record for each call.
+  if (hoist_ground_calls && !proof_hint_instrumentation) {
+    populate_hoisted_set(pattern);
+  }
 
   return create_allocation(pattern);
 }
@@ -918,6 +1650,141 @@ bool create_term::populate_static_set(kore_pattern *pattern) {
   return can_be_static;
 }
 
+// Function calls whose arguments are all invariant are candidates for
+// hoisting: if the function is total and has no side effects, its result is
+// the same every time the rule is applied, and can be computed once and cached
+// in a global. Returns true if the pattern evaluates to the same term every
+// time, which holds for domain values, constructors applied to invariant
+// arguments, and total, pure functions applied to invariant arguments.
+bool create_term::populate_hoisted_set(kore_pattern *pattern) {
+  auto *constructor = dynamic_cast<kore_composite_pattern *>(pattern);
+  if (!constructor) {
+    return dynamic_cast<kore_variable_pattern *>(pattern) == nullptr;
+  }
+
+  bool is_invariant = true;
+  for (auto const &arg : constructor->get_arguments()) {
+    is_invariant &= populate_hoisted_set(arg.get());
+  }
+
+  kore_symbol const *symbol = constructor->get_constructor();
+  if (!is_invariant || symbol->get_name() == "\\dv") {
+    return is_invariant;
+  }
+
+  auto const &att = definition_->get_symbol_declarations()
+                        .at(symbol->get_name())
+                        ->attributes();
+  if (!att.contains(attribute_set::key::Function)) {
+    // Anywhere rules may rewrite a constructor when it is built.
+    return !att.contains(attribute_set::key::Anywhere);
+  }
+  if (!(att.contains(attribute_set::key::Total)
+        || att.contains(attribute_set::key::Functional))
+      || att.contains(attribute_set::key::Impure)) {
+    return false;
+  }
+
+  // Only results that are a single pointer to a heap object can be cached
+  // and traced by the garbage collector as a static root. Bytes are excluded
+  // because some of their hooks update them in place.
+  auto *sort
+      = dynamic_cast<kore_composite_sort *>(constructor->get_sort().get());
+  switch (sort->get_category(definition_).cat) {
+  case sort_category::Int:
+  case sort_category::Float: break;
+  case sort_category::Symbol:
+    if (sort->get_hook(definition_) == "BYTES.Bytes") {
+      return true;
+    }
+    break;
+  default: return true;
+  }
+
+  hoisted_calls_.insert(pattern);
+  return true;
+}
+
+// Emits a lazily initialized global caching the result of a hoisted function
+// call. The global starts out null; the first time it is used, the call is
+// evaluated, its result stored, and the global registered with the garbage
+// collector so that migrate_static_roots keeps it alive and up to date.
+llvm::Value *create_term::create_hoisted_call(
+    kore_composite_pattern *pattern, std::string const &location_stack) {
+  auto *sort = dynamic_cast<kore_composite_sort *>(pattern->get_sort().get());
+  auto cat = sort->get_category(definition_);
+  auto *type = getvalue_type(cat, module_);
+  auto *cache = new llvm::GlobalVariable(
+      *module_, type, false, llvm::GlobalValue::InternalLinkage,
+      llvm::Constant::getNullValue(type),
+      fmt::format(
+          "hoisted_{}", ast_to_string(*pattern->get_constructor(), 0, false)));
+
+  auto *cached = new llvm::LoadInst(type, cache, "cached", current_block_);
+  auto *is_init = new llvm::ICmpInst(
+      *current_block_, llvm::CmpInst::ICMP_NE, cached,
+      llvm::Constant::getNullValue(type));
+  auto *cached_block = current_block_;
+  auto *init_block = llvm::BasicBlock::Create(
+      ctx_, "hoisted_init", current_block_->getParent());
+  auto *merge_block = llvm::BasicBlock::Create(
+      ctx_, "hoisted_merge", current_block_->getParent());
+  auto *branch = llvm::BranchInst::Create(
+      merge_block, init_block, is_init, current_block_);
+  set_cold_successor(branch, 1);
+
+  current_block_ = init_block;
+  llvm::Value *val = create_function_allocation(pattern, location_stack);
+  new llvm::StoreInst(val, cache, current_block_);
+  auto *register_root = llvm::CallInst::Create(
+      get_or_insert_function(
+          module_, "register_hoisted_root", llvm::Type::getVoidTy(ctx_),
+          cache->getType(), llvm::Type::getInt16Ty(ctx_)),
+      {cache,
+       llvm::ConstantInt::get(
+           llvm::Type::getInt16Ty(ctx_), (int)cat.cat + cat.bits)},
+      "", current_block_);
+  set_debug_loc(register_root);
+  llvm::BranchInst::Create(merge_block, current_block_);
+  auto *init_end = current_block_;
+
+  current_block_ = merge_block;
+  auto *phi = llvm::PHINode::Create(type, 2, "hoisted", current_block_);
+  phi->addIncoming(cached, cached_block);
+  phi->addIncoming(val, init_end);
+  return phi;
+}
+
+llvm::Value *create_term::create_function_allocation(
+    kore_composite_pattern *constructor, std::string const &location_stack) {
+  kore_symbol const *symbol = constructor->get_constructor();
+  kore_symbol_declaration *symbol_decl
+      = definition_->get_symbol_declarations().at(symbol->get_name());
+  if (symbol_decl->attributes().contains(attribute_set::key::Hook)) {
+    auto *sort
+        = dynamic_cast<kore_composite_sort *>(constructor->get_sort().get());
+    auto *str_pattern = dynamic_cast<kore_string_pattern *>(
+        symbol_decl->attributes()
+            .get(attribute_set::key::Hook)
+            ->get_arguments()[0]
+            .get());
+    std::string name = str_pattern->get_contents();
+
+    proof_event p(definition_, module_);
+    current_block_
+        = p.hook_event_pre(name, constructor, current_block_, location_stack);
+    llvm::Value *val = create_hook(
+        symbol_decl->attributes().get(attribute_set::key::Hook).get(),
+        constructor, location_stack);
+    current_block_ = p.hook_event_post(val, constructor, sort, current_block_);
+
+    return val;
+  }
+  auto fn_name = fmt::format("eval_{}", ast_to_string(*symbol, 0, false));
+  return create_function_call(
+      fn_name, constructor, false, true, false, location_stack);
+}
+
 std::pair<llvm::Value *, bool> create_term::create_allocation(
     kore_pattern *pattern, std::string const &location_stack) {
   if (static_terms_.contains(pattern)) {
@@ -941,31 +1808,15 @@ std::pair<llvm::Value *, bool> create_term::create_allocation(
     if (symbol_decl->attributes().contains(attribute_set::key::Function)
         || (symbol_decl->attributes().contains(attribute_set::key::Anywhere)
             && !is_anywhere_owise_)) {
-      if (symbol_decl->attributes().contains(attribute_set::key::Hook)) {
-        auto *sort = dynamic_cast<kore_composite_sort *>(
-            constructor->get_sort().get());
-        auto *str_pattern = dynamic_cast<kore_string_pattern *>(
-            symbol_decl->attributes()
-                .get(attribute_set::key::Hook)
-                ->get_arguments()[0]
-                .get());
-        std::string name = str_pattern->get_contents();
-
-        proof_event p(definition_, module_);
-        current_block_ = p.hook_event_pre(
-            name, constructor, current_block_, location_stack);
-        llvm::Value *val = create_hook(
-            symbol_decl->attributes().get(attribute_set::key::Hook).get(),
-            constructor, location_stack);
-        current_block_ = p.hook_event_post(val, sort, current_block_);
-
-        return std::make_pair(val, true);
+      bool may_be_injection
+          = definition_->may_return_injection(symbol->get_name());
+      if (hoisted_calls_.contains(pattern)) {
+        return std::make_pair(
+            create_hoisted_call(constructor, location_stack), may_be_injection);
       }
-      auto fn_name = fmt::format("eval_{}", ast_to_string(*symbol, 0, false));
       return std::make_pair(
-          create_function_call(
-              fn_name, constructor, false, true, false, location_stack),
-          true);
+          create_function_allocation(constructor, location_stack),
+          may_be_injection);
     }
     if (auto *sort
         = dynamic_cast<kore_composite_sort *>(symbol->get_arguments()[0].get());
@@ -1036,6 +1887,7 @@ void add_abort(llvm::BasicBlock *block, llvm::Module *module) {
   llvm::Function *abort_func
       = get_or_insert_function(module, "abort", abort_type);
   abort_func->addFnAttr(llvm::Attribute::NoReturn);
+  abort_func->addFnAttr(llvm::Attribute::Cold);
   llvm::CallInst::Create(abort_func, "", block);
   new llvm::UnreachableInst(module->getContext(), block);
 }
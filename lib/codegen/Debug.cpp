@@ -27,10 +27,17 @@ static llvm::DISubprogram *dbg_sp;
 static unsigned dbg_line;
 static unsigned dbg_column;
 
+// In line-tables-only mode we emit subprograms and locations only; types,
+// parameters and globals are skipped.
+static bool dbg_line_tables_only;
+
 #define DWARF_VERSION 4
 
-void init_debug_info(llvm::Module *module, std::string const &filename) {
+void init_debug_info(
+    llvm::Module *module, std::string const &filename,
+    bool line_tables_only) {
   dbg = new llvm::DIBuilder(*module);
+  dbg_line_tables_only = line_tables_only;
   dbg_file = dbg->createFile(filename, ".");
 
   module->addModuleFlag(
@@ -47,9 +54,13 @@ void init_debug_info(llvm::Module *module, std::string const &filename) {
   // arguments to createCompileUnit:
   //   https://github.com/runtimeverification/k/issues/2637
   //   https://llvm.org/doxygen/classllvm_1_1DIBuilder.html
+  auto emission_kind
+      = line_tables_only
+            ? llvm::DICompileUnit::DebugEmissionKind::LineTablesOnly
+            : llvm::DICompileUnit::DebugEmissionKind::FullDebug;
   dbg_cu = dbg->createCompileUnit(
       llvm::dwarf::DW_LANG_C, dbg_file, "llvm-kompile-codegen", false, "", 0,
-      "", llvm::DICompileUnit::DebugEmissionKind::FullDebug, 0, false, false,
+      "", emission_kind, 0, false, false,
       llvm::DICompileUnit::DebugNameTableKind::None);
 }
 
@@ -64,11 +75,8 @@ void init_debug_function(
   if (!dbg) {
     return;
   }
-  auto *unit
-      = dbg->createFile(dbg_file->getFilename(), dbg_file->getDirectory());
-  llvm::DIScope *f_context = unit;
   dbg_sp = dbg->createFunction(
-      f_context, name, name, unit, dbg_line, type, dbg_line,
+      dbg_file, name, name, dbg_file, dbg_line, type, dbg_line,
       llvm::DINode::DIFlags::FlagZero, llvm::DISubprogram::SPFlagDefinition);
   func->setSubprogram(dbg_sp);
 }
@@ -76,7 +84,7 @@ void init_debug_function(
 void init_debug_param(
     llvm::Function *func, unsigned arg_no, std::string const &name,
     value_type type, std::string const &type_name) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return;
   }
   llvm::DILocalVariable *dbg_var = dbg->createParameterVariable(
@@ -90,7 +98,7 @@ void init_debug_param(
 
 void init_debug_global(
     std::string const &name, llvm::DIType *type, llvm::GlobalVariable *var) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return;
   }
   reset_debug_loc();
@@ -142,13 +150,11 @@ void reset_debug_loc() {
 }
 
 llvm::DIType *get_forward_decl(std::string const &name) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
-  auto *unit
-      = dbg->createFile(dbg_file->getFilename(), dbg_file->getDirectory());
   return dbg->createForwardDecl(
-      llvm::dwarf::DW_TAG_structure_type, name, dbg_cu, unit, 0);
+      llvm::dwarf::DW_TAG_structure_type, name, dbg_cu, dbg_file, 0);
 }
 
 static std::string map_struct = "map";
@@ -162,7 +168,7 @@ static std::string buffer_struct = "stringbuffer";
 static std::string block_struct = "block";
 
 llvm::DIType *get_debug_type(value_type type, std::string const &type_name) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   static std::map<std::string, llvm::DIType *> types;
@@ -239,21 +245,21 @@ llvm::DIType *get_debug_type(value_type type, std::string const &type_name) {
 }
 
 llvm::DIType *get_int_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createBasicType("uint32_t", 32, llvm::dwarf::DW_ATE_unsigned);
 }
 
 llvm::DIType *get_long_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createBasicType("uint64_t", 64, llvm::dwarf::DW_ATE_unsigned);
 }
 
 llvm::DIType *get_bool_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createBasicType("bool", 8, llvm::dwarf::DW_ATE_boolean);
@@ -264,7 +270,7 @@ llvm::DIType *get_void_debug_type() {
 }
 
 llvm::DIType *get_char_ptr_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createPointerType(
@@ -273,7 +279,7 @@ llvm::DIType *get_char_ptr_debug_type() {
 }
 
 llvm::DIType *get_char_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createBasicType("char", 8, llvm::dwarf::DW_ATE_signed_char);
@@ -281,7 +287,7 @@ llvm::DIType *get_char_debug_type() {
 
 llvm::DIType *
 get_pointer_debug_type(llvm::DIType *ty, std::string const &type_name) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   auto *ptr_type = dbg->createPointerType(ty, sizeof(size_t) * 8);
@@ -290,7 +296,7 @@ get_pointer_debug_type(llvm::DIType *ty, std::string const &type_name) {
 
 llvm::DIType *
 get_array_debug_type(llvm::DIType *ty, size_t len, llvm::Align align) {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   std::vector<llvm::Metadata *> subscripts;
@@ -299,7 +305,7 @@ get_array_debug_type(llvm::DIType *ty, size_t len, llvm::Align align) {
 }
 
 llvm::DIType *get_short_debug_type() {
-  if (!dbg) {
+  if (!dbg || dbg_line_tables_only) {
     return nullptr;
   }
   return dbg->createBasicType("uint16_t", 16, llvm::dwarf::DW_ATE_unsigned);
@@ -310,6 +316,9 @@ llvm::DISubroutineType *get_debug_function_type(
   if (!dbg) {
     return nullptr;
   }
+  if (dbg_line_tables_only) {
+    return dbg->createSubroutineType(dbg->getOrCreateTypeArray({}));
+  }
   arg_types.insert(arg_types.begin(), return_type);
   return dbg->createSubroutineType(dbg->getOrCreateTypeArray(arg_types));
 }
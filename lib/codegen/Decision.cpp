@@ -2,6 +2,7 @@
 
 #include "kllvm/codegen/CreateTerm.h"
 #include "kllvm/codegen/Debug.h"
+#include "kllvm/codegen/Options.h"
 #include "kllvm/codegen/ProofEvent.h"
 #include "kllvm/codegen/Util.h"
 
@@ -411,6 +412,179 @@ static std::string legacy_value_type_to_string(value_type sort) {
   }
 }
 
+/*
+ * The generated counter is incremented once per fresh constant, so it only
+ * leaves the range of a single limb after 2^64 - 1 fresh constants. We
+ * therefore read the limb of the counter directly and box counter + 1 with
+ * hook_MINT_import, and only fall back to hook_INT_add on the cold path where
+ * the counter is negative or does not fit in one limb.
+ */
+llvm::Value *
+function_node::codegen_increment_counter(decision *d, llvm::Value *counter) {
+  auto *i32_ty = llvm::Type::getInt32Ty(d->ctx_);
+  auto *i64_ty = llvm::Type::getInt64Ty(d->ctx_);
+  auto *ptr_ty = llvm::PointerType::getUnqual(d->ctx_);
+  auto *mpz_ty = llvm::StructType::getTypeByName(d->ctx_, int_struct);
+  auto *func = d->current_block_->getParent();
+
+  auto *zero_block = llvm::BasicBlock::Create(d->ctx_, "counter_zero", func);
+  auto *limb_block = llvm::BasicBlock::Create(d->ctx_, "counter_limb", func);
+  auto *small_block = llvm::BasicBlock::Create(d->ctx_, "counter_small", func);
+  auto *big_block = llvm::BasicBlock::Create(d->ctx_, "counter_big", func);
+  auto *merge_block = llvm::BasicBlock::Create(d->ctx_, "counter_next", func);
+
+  // The layout of an mpz is {i32 alloc, i32 size, i64 *limbs}; the size is
+  // 0 for the counter 0 and 1 for any other counter below 2^64.
+  auto *size_ptr = llvm::GetElementPtrInst::CreateInBounds(
+      mpz_ty, counter,
+      {llvm::ConstantInt::get(i64_ty, 0), llvm::ConstantInt::get(i32_ty, 1)},
+      "counter_size_ptr", d->current_block_);
+  auto *size
+      = new llvm::LoadInst(i32_ty, size_ptr, "counter_size", d->current_block_);
+  auto *is_one = new llvm::ICmpInst(
+      *d->current_block_, llvm::CmpInst::ICMP_EQ, size,
+      llvm::ConstantInt::get(i32_ty, 1));
+  llvm::BranchInst::Create(limb_block, zero_block, is_one, d->current_block_);
+
+  auto *is_zero = new llvm::ICmpInst(
+      *zero_block, llvm::CmpInst::ICMP_EQ, size,
+      llvm::ConstantInt::get(i32_ty, 0));
+  set_cold_successor(
+      llvm::BranchInst::Create(small_block, big_block, is_zero, zero_block), 1);
+
+  auto *limbs_ptr = llvm::GetElementPtrInst::CreateInBounds(
+      mpz_ty, counter,
+      {llvm::ConstantInt::get(i64_ty, 0), llvm::ConstantInt::get(i32_ty, 2)},
+      "counter_limbs_ptr", limb_block);
+  auto *limbs
+      = new llvm::LoadInst(ptr_ty, limbs_ptr, "counter_limbs", limb_block);
+  auto *limb = new llvm::LoadInst(i64_ty, limbs, "counter_limb", limb_block);
+  auto *is_max = new llvm::ICmpInst(
+      *limb_block, llvm::CmpInst::ICMP_EQ, limb,
+      llvm::ConstantInt::getAllOnesValue(i64_ty));
+  set_cold_successor(
+      llvm::BranchInst::Create(big_block, small_block, is_max, limb_block), 0);
+
+  auto *word = llvm::PHINode::Create(i64_ty, 2, "counter_word", small_block);
+  word->addIncoming(llvm::ConstantInt::get(i64_ty, 0), zero_block);
+  word->addIncoming(limb, limb_block);
+  auto *next_word = llvm::BinaryOperator::Create(
+      llvm::Instruction::Add, word, llvm::ConstantInt::get(i64_ty, 1),
+      "next_counter_word", small_block);
+  auto &entry = func->getEntryBlock();
+  llvm::AllocaInst *buffer = nullptr;
+  if (auto *first = entry.getFirstNonPHI()) {
+    buffer = new llvm::AllocaInst(i64_ty, 0, "counter_buffer", first);
+  } else {
+    buffer = new llvm::AllocaInst(i64_ty, 0, "counter_buffer", &entry);
+  }
+  new llvm::StoreInst(next_word, buffer, small_block);
+  auto *small_next = llvm::CallInst::Create(
+      get_or_insert_function(
+          d->module_, "hook_MINT_import", ptr_ty, ptr_ty, i64_ty,
+          llvm::Type::getInt1Ty(d->ctx_)),
+      {buffer, llvm::ConstantInt::get(i64_ty, 64),
+       llvm::ConstantInt::getFalse(d->ctx_)},
+      "small_next_counter", small_block);
+  set_debug_loc(small_next);
+  llvm::BranchInst::Create(merge_block, small_block);
+
+  auto *one = d->module_->getOrInsertGlobal("fresh_int_1", mpz_ty);
+  auto *big_next = llvm::CallInst::Create(
+      get_or_insert_function(
+          d->module_, "hook_INT_add", ptr_ty, ptr_ty, ptr_ty),
+      {counter, one}, "big_next_counter", big_block);
+  set_debug_loc(big_next);
+  llvm::BranchInst::Create(merge_block, big_block);
+
+  auto *next = llvm::PHINode::Create(ptr_ty, 2, "next_counter", merge_block);
+  next->addIncoming(small_next, small_block);
+  next->addIncoming(big_next, big_block);
+  d->current_block_ = merge_block;
+  return next;
+}
+
+/*
+ * Fresh constants are requested by the matching compiler as a call to
+ * get_fresh_constant, with the name of the fresh sort bound as a string literal
+ * and the top cell of the configuration. The sort is therefore known at
+ * compile time, and we can increment the generated counter inline and apply
+ * the fresh generator for that sort through create_term, which emits either a
+ * call to its eval_ function or, for a hooked generator, the hook itself. This
+ * avoids copying the sort name and looking it up with get_tag_for_fresh_sort
+ * on every fresh constant.
+ *
+ * With proof hints enabled we keep the runtime call: get_fresh_constant emits
+ * no events, whereas create_term would add function and hook events that the
+ * proof checker does not expect at this point of the trace.
+ */
+llvm::Value *function_node::codegen_fresh_constant(
+    decision *d, std::vector<llvm::Value *> const &args) {
+  if (proof_hint_instrumentation) {
+    return nullptr;
+  }
+
+  std::string const prefix = "_lit_";
+  std::string const suffix = "_STRING.String";
+  auto const &literal = bindings_[0].first.first;
+  if (literal.size() <= prefix.size() + suffix.size()
+      || literal.compare(0, prefix.size(), prefix) != 0
+      || literal.compare(
+             literal.size() - suffix.size(), suffix.size(), suffix)
+             != 0) {
+    return nullptr;
+  }
+  auto sort_name = literal.substr(
+      prefix.size(), literal.size() - prefix.size() - suffix.size());
+
+  auto const &fresh_functions = d->definition_->get_fresh_functions();
+  if (!fresh_functions.contains(sort_name)) {
+    return nullptr;
+  }
+  switch (cat_.cat) {
+  case sort_category::Int:
+  case sort_category::Float:
+  case sort_category::Symbol: break;
+  default: return nullptr;
+  }
+
+  auto *ptr_ty = llvm::PointerType::getUnqual(d->ctx_);
+  auto *counter_cell = llvm::CallInst::Create(
+      get_or_insert_function(
+          d->module_,
+          "eval_LblgetGeneratedCounterCell{SortGeneratedTopCell{}}", ptr_ty,
+          ptr_ty),
+      {args[1]}, "counter_cell", d->current_block_);
+  set_debug_loc(counter_cell);
+  counter_cell->setCallingConv(llvm::CallingConv::Tail);
+
+  auto *block_ty = get_block_type(d->module_);
+  auto *counter_ptr = llvm::GetElementPtrInst::CreateInBounds(
+      block_ty, counter_cell,
+      {llvm::ConstantInt::get(llvm::Type::getInt64Ty(d->ctx_), 0),
+       llvm::ConstantInt::get(llvm::Type::getInt32Ty(d->ctx_), 1),
+       llvm::ConstantInt::get(llvm::Type::getInt64Ty(d->ctx_), 0)},
+      "counter_ptr", d->current_block_);
+  auto *counter
+      = new llvm::LoadInst(ptr_ty, counter_ptr, "counter", d->current_block_);
+  auto *next = codegen_increment_counter(d, counter);
+  new llvm::StoreInst(next, counter_ptr, d->current_block_);
+
+  auto *symbol = d->definition_->get_all_symbols().at(
+      ast_to_string(*fresh_functions.at(sort_name)));
+  auto pattern = kore_composite_pattern::create(symbol);
+  pattern->add_argument(
+      kore_variable_pattern::create("_counter", symbol->get_arguments()[0]));
+  llvm::StringMap<llvm::Value *> subst;
+  subst["_counter"] = counter;
+  create_term creator(
+      subst, d->definition_, d->current_block_, d->module_, false);
+  auto *fresh = creator(pattern.get()).first;
+  d->current_block_ = creator.get_current_block();
+
+  return fresh;
+}
+
 void function_node::codegen(decision *d) {
   if (begin_node(d, "function" + name_)) {
     return;
@@ -438,10 +612,18 @@ void function_node::codegen(decision *d) {
         = p.side_condition_event_pre(axiom, args, d->current_block_);
   }
 
-  create_term creator(
-      final_subst, d->definition_, d->current_block_, d->module_, false);
-  auto *call = creator.create_function_call(
-      function_, cat_, args, function_.substr(0, 5) == "hook_", false);
+  llvm::Value *call = nullptr;
+  if (function_ == "get_fresh_constant") {
+    call = codegen_fresh_constant(d, args);
+  } else if (function_ == "hook_KEQUAL_eq") {
+    call = create_kequal_eq(args[0], args[1], d->current_block_, d->module_);
+  }
+  if (!call) {
+    create_term creator(
+        final_subst, d->definition_, d->current_block_, d->module_, false);
+    call = creator.create_function_call(
+        function_, cat_, args, function_.substr(0, 5) == "hook_", false);
+  }
   call->setName(name_.substr(0, max_name_length));
   d->store(std::make_pair(name_, type_), call);
 
@@ -882,6 +1064,7 @@ void abort_when_stuck(
       module, "finish_rewriting", llvm::Type::getVoidTy(ctx), block_ptr,
       llvm::Type::getInt1Ty(ctx));
   func->setDoesNotReturn();
+  func->addFnAttr(llvm::Attribute::Cold);
   llvm::CallInst::Create(
       func, {ptr, llvm::ConstantInt::getTrue(ctx)}, "", current_block);
   new llvm::UnreachableInst(ctx, current_block);
@@ -987,7 +1170,8 @@ std::pair<std::vector<llvm::Value *>, llvm::BasicBlock *> step_function_header(
   auto *is_finished = llvm::CallInst::Create(finished, {}, "", block);
   auto *check_collect = llvm::BasicBlock::Create(
       module->getContext(), "checkCollect", block->getParent());
-  llvm::BranchInst::Create(stuck, check_collect, is_finished, block);
+  set_cold_successor(
+      llvm::BranchInst::Create(stuck, check_collect, is_finished, block), 0);
 
   auto *collection = get_or_insert_function(
       module, "is_collection",
@@ -1000,7 +1184,9 @@ std::pair<std::vector<llvm::Value *>, llvm::BasicBlock *> step_function_header(
       module->getContext(), "isCollect", block->getParent());
   auto *merge = llvm::BasicBlock::Create(
       module->getContext(), "step", block->getParent());
-  llvm::BranchInst::Create(collect, merge, is_collection, check_collect);
+  set_cold_successor(
+      llvm::BranchInst::Create(collect, merge, is_collection, check_collect),
+      0);
 
   unsigned nroots = 0;
   unsigned i = 0;
@@ -1289,15 +1475,16 @@ void make_match_reason_function(
       llvm::PointerType::getUnqual(llvm::Type::getInt8Ty(module->getContext())),
       0, "sort", fail);
 
+  auto *add_fail_reason = get_or_insert_function(
+      module, "add_match_fail_reason",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(module->getContext()),
+          {fail_subject->getType(), fail_pattern->getType(),
+           fail_sort->getType()},
+          false));
+  add_fail_reason->addFnAttr(llvm::Attribute::Cold);
   auto *call = llvm::CallInst::Create(
-      get_or_insert_function(
-          module, "add_match_fail_reason",
-          llvm::FunctionType::get(
-              llvm::Type::getVoidTy(module->getContext()),
-              {fail_subject->getType(), fail_pattern->getType(),
-               fail_sort->getType()},
-              false)),
-      {fail_subject, fail_pattern, fail_sort}, "", fail);
+      add_fail_reason, {fail_subject, fail_pattern, fail_sort}, "", fail);
   set_debug_loc(call);
 
   llvm::AllocaInst *choice_buffer = nullptr;
@@ -32,6 +32,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -1288,6 +1289,11 @@ static void emit_layouts(kore_definition *definition, llvm::Module *module) {
   for (auto entry : layouts) {
     uint16_t layout = entry.first;
     auto *symbol = entry.second;
+    if (layout >= ROPE_LAYOUT) {
+      // The largest layout id is reserved for ropes by the runtime.
+      throw std::runtime_error(fmt::format(
+          "Definition has too many distinct symbol layouts: {}", layout));
+    }
     auto *case_block = llvm::BasicBlock::Create(
         ctx, "layout" + std::to_string(layout), func);
     llvm::BranchInst::Create(merge_block, case_block);
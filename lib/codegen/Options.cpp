@@ -15,11 +15,56 @@ cl::opt<bool> proof_hint_instrumentation_slow(
                    "contain function argument KORE terms as part of the trace"),
     llvm::cl::cat(codegen_lib_cat));
 
+cl::list<std::string> proof_hint_filter(
+    "proof-hint-filter",
+    llvm::cl::desc("Only instrument proof hint events for the given rule "
+                   "labels, modules, function symbols and hooks"),
+    llvm::cl::CommaSeparated, llvm::cl::cat(codegen_lib_cat));
+
 cl::opt<bool> keep_frame_pointer(
     "fno-omit-frame-pointer",
     cl::desc("Keep frame pointer in compiled code for debugging purposes"),
     cl::cat(codegen_lib_cat));
 
+cl::opt<bool> hoist_ground_calls(
+    "hoist-ground-calls",
+    cl::desc("Evaluate calls to total, pure functions with ground arguments "
+             "only once, and reuse their result on later rule applications"),
+    cl::init(true), cl::cat(codegen_lib_cat));
+
+cl::opt<bool> merge_functions(
+    "merge-functions",
+    cl::desc("Emit functions with identical generated code, such as the side "
+             "conditions shared by many rules, only once. Has no effect when "
+             "emitting debug info"),
+    cl::init(true), cl::cat(codegen_lib_cat));
+
+cl::opt<bool> hot_cold_split(
+    "hot-cold-split",
+    cl::desc("Outline code that only leads to a cold call, such as an abort "
+             "or a stuck function, out of the generated functions"),
+    cl::init(true), cl::cat(codegen_lib_cat));
+
+cl::opt<bool> pretenure_online(
+    "pretenure-online",
+    cl::desc("Decide at run time which constructors to allocate directly in "
+             "the old generation, based on how often their terms survive "
+             "into it"),
+    cl::cat(codegen_lib_cat));
+
+cl::opt<std::string> pretenure_profile(
+    "pretenure-profile",
+    cl::desc("Allocate constructors whose survival rate in the given profile "
+             "is at least --pretenure-threshold directly in the old "
+             "generation"),
+    cl::value_desc("file"), cl::cat(codegen_lib_cat));
+
+cl::opt<double> pretenure_threshold(
+    "pretenure-threshold",
+    cl::desc("Fraction of the terms of a constructor that must survive into "
+             "the old generation for --pretenure-profile to pretenure it"),
+    cl::init(0.5), cl::cat(codegen_lib_cat));
+
 cl::opt<opt_level> optimization_level(
     cl::desc("Choose optimization level"),
     cl::values(
@@ -33,6 +78,12 @@ cl::opt<bool> debug(
     "debug", cl::desc("Enable debug information"), cl::ZeroOrMore,
     cl::cat(codegen_lib_cat));
 
+cl::opt<bool> debug_line_tables_only(
+    "debug-line-tables-only",
+    cl::desc("Enable debug information containing only source locations, "
+             "without types or variables"),
+    cl::ZeroOrMore, cl::cat(codegen_lib_cat));
+
 cl::opt<bool> no_optimize(
     "no-optimize",
     cl::desc("Don't run optimization passes before producing output"),
@@ -59,6 +110,11 @@ void validate_codegen_args(bool is_tty) {
         "Cannot specify --emit-object with --binary-ir or --no-optimize");
   }
 
+  if (pretenure_online && !pretenure_profile.empty()) {
+    throw std::runtime_error(
+        "Cannot specify --pretenure-online with --pretenure-profile");
+  }
+
   if ((emit_object || binary_ir) && is_tty && !force_binary) {
     throw std::runtime_error(
         "Not printing binary file to stdout; use -o to specify output path "
@@ -9,6 +9,8 @@
 
 #include <fmt/format.h>
 
+#include <unordered_set>
+
 namespace kllvm {
 
 /*
@@ -24,8 +26,55 @@ llvm::Constant *create_global_sort_string_ptr(
       ast_to_string(sort), fmt::format("{}_str", sort.get_name()), 0, mod);
 }
 
+std::unordered_set<std::string> const &filter_entries() {
+  static auto entries = std::unordered_set<std::string>(
+      proof_hint_filter.begin(), proof_hint_filter.end());
+  return entries;
+}
+
+// Matches either the full name or the part of it before the first '.', so that
+// `MODULE` selects the rule labelled `MODULE.rule` and `INT` selects the hook
+// `INT.add`.
+bool matches_filter(std::string const &name) {
+  auto const &entries = filter_entries();
+  return entries.contains(name)
+         || entries.contains(name.substr(0, name.find('.')));
+}
+
 } // namespace
 
+bool proof_event::is_selected(kore_axiom_declaration const &axiom) {
+  if (proof_hint_filter.empty()) {
+    return true;
+  }
+
+  // A label is prefixed by the K module that declares the rule. Unlabelled
+  // rules carry no such prefix, so we fall back to the KORE module the axiom
+  // was parsed from.
+  if (axiom.attributes().contains(attribute_set::key::Label)) {
+    return matches_filter(
+        axiom.attributes().get_string(attribute_set::key::Label));
+  }
+
+  return matches_filter(axiom.get_module_name());
+}
+
+bool proof_event::is_selected(kore_composite_pattern *pattern) {
+  if (proof_hint_filter.empty()) {
+    return true;
+  }
+
+  auto const &name = pattern->get_constructor()->get_name();
+  if (filter_entries().contains(name)) {
+    return true;
+  }
+
+  auto const &att
+      = definition_->get_symbol_declarations().at(name)->attributes();
+  return att.contains(attribute_set::key::Hook)
+         && matches_filter(att.get_string(attribute_set::key::Hook));
+}
+
 llvm::CallInst *proof_event::emit_serialize_term(
     kore_composite_sort &sort, llvm::Value *output_file, llvm::Value *term,
     llvm::BasicBlock *insert_at_end) {
@@ -133,13 +182,36 @@ proof_event::emit_get_output_file_name(llvm::BasicBlock *insert_at_end) {
       i8_ptr_ty, file_name_pointer, "output", insert_at_end);
 }
 
+llvm::Value *proof_event::emit_kind_enabled(
+    proof_hint_kind kind, llvm::BasicBlock *insert_at_end) {
+  auto *i64_ty = llvm::Type::getInt64Ty(ctx_);
+
+  auto *mask_global = module_->getOrInsertGlobal("proof_hint_mask", i64_ty);
+  auto *mask = new llvm::LoadInst(
+      i64_ty, mask_global, "proof_hint_mask", insert_at_end);
+  auto *bit = llvm::BinaryOperator::Create(
+      llvm::Instruction::And, mask,
+      llvm::ConstantInt::get(i64_ty, static_cast<uint64_t>(kind)), "kind_bit",
+      insert_at_end);
+  return new llvm::ICmpInst(
+      *insert_at_end, llvm::CmpInst::ICMP_NE, bit,
+      llvm::ConstantInt::get(i64_ty, 0), "kind_enabled");
+}
+
 std::pair<llvm::BasicBlock *, llvm::BasicBlock *> proof_event::proof_branch(
-    std::string const &label, llvm::BasicBlock *insert_at_end) {
+    std::string const &label, llvm::BasicBlock *insert_at_end,
+    std::optional<proof_hint_kind> kind) {
   auto *i1_ty = llvm::Type::getInt1Ty(ctx_);
 
   auto *proof_output_flag = module_->getOrInsertGlobal("proof_output", i1_ty);
-  auto *proof_output = new llvm::LoadInst(
+  llvm::Value *proof_output = new llvm::LoadInst(
       i1_ty, proof_output_flag, "proof_output", insert_at_end);
+  if (kind) {
+    proof_output = llvm::BinaryOperator::Create(
+        llvm::Instruction::And, proof_output,
+        emit_kind_enabled(*kind, insert_at_end), "event_enabled",
+        insert_at_end);
+  }
 
   auto *f = insert_at_end->getParent();
   auto *true_block
@@ -149,15 +221,19 @@ std::pair<llvm::BasicBlock *, llvm::BasicBlock *> proof_event::proof_branch(
 
   emit_no_op(merge_block);
 
-  llvm::BranchInst::Create(
+  // Proof hints are only written when tracing is enabled at run time; keep the
+  // code that writes them out of the way of the rule code around it.
+  auto *branch = llvm::BranchInst::Create(
       true_block, merge_block, proof_output, insert_at_end);
+  set_cold_successor(branch, 0);
   return {true_block, merge_block};
 }
 
 std::tuple<llvm::BasicBlock *, llvm::BasicBlock *, llvm::Value *>
 proof_event::event_prelude(
-    std::string const &label, llvm::BasicBlock *insert_at_end) {
-  auto [true_block, merge_block] = proof_branch(label, insert_at_end);
+    std::string const &label, llvm::BasicBlock *insert_at_end,
+    std::optional<proof_hint_kind> kind) {
+  auto [true_block, merge_block] = proof_branch(label, insert_at_end, kind);
   return {true_block, merge_block, emit_get_output_file_name(true_block)};
 }
 
@@ -168,12 +244,12 @@ proof_event::event_prelude(
 llvm::BasicBlock *proof_event::hook_event_pre(
     std::string const &name, kore_composite_pattern *pattern,
     llvm::BasicBlock *current_block, std::string const &location_stack) {
-  if (!proof_hint_instrumentation) {
+  if (!proof_hint_instrumentation || !is_selected(pattern)) {
     return current_block;
   }
 
   auto [true_block, merge_block, outputFile]
-      = event_prelude("hookpre", current_block);
+      = event_prelude("hookpre", current_block, proof_hint_kind::Hook);
 
   emit_write_uint64(outputFile, detail::word(0xAA), true_block);
   emit_write_string(outputFile, name, true_block);
@@ -186,14 +262,14 @@ llvm::BasicBlock *proof_event::hook_event_pre(
 }
 
 llvm::BasicBlock *proof_event::hook_event_post(
-    llvm::Value *val, kore_composite_sort *sort,
-    llvm::BasicBlock *current_block) {
-  if (!proof_hint_instrumentation) {
+    llvm::Value *val, kore_composite_pattern *pattern,
+    kore_composite_sort *sort, llvm::BasicBlock *current_block) {
+  if (!proof_hint_instrumentation || !is_selected(pattern)) {
     return current_block;
   }
 
   auto [true_block, merge_block, outputFile]
-      = event_prelude("hookpost", current_block);
+      = event_prelude("hookpost", current_block, proof_hint_kind::Hook);
 
   emit_write_uint64(outputFile, detail::word(0xBB), true_block);
 
@@ -208,9 +284,9 @@ llvm::BasicBlock *proof_event::hook_event_post(
  */
 
 llvm::BasicBlock *proof_event::argument(
-    llvm::Value *val, kore_composite_sort *sort, bool is_hook_arg,
-    llvm::BasicBlock *current_block) {
-  if (!proof_hint_instrumentation) {
+    llvm::Value *val, kore_composite_pattern *call, kore_composite_sort *sort,
+    bool is_hook_arg, llvm::BasicBlock *current_block) {
+  if (!proof_hint_instrumentation || !is_selected(call)) {
     return current_block;
   }
 
@@ -218,8 +294,9 @@ llvm::BasicBlock *proof_event::argument(
     return current_block;
   }
 
-  auto [true_block, merge_block, outputFile]
-      = event_prelude("eventarg", current_block);
+  auto [true_block, merge_block, outputFile] = event_prelude(
+      "eventarg", current_block,
+      is_hook_arg ? proof_hint_kind::Hook : proof_hint_kind::Function);
 
   emit_serialize_term(*sort, outputFile, val, true_block);
 
@@ -243,6 +320,26 @@ llvm::BasicBlock *proof_event::rewrite_event_pre(
   auto [true_block, merge_block, outputFile]
       = event_prelude("rewrite_pre", current_block);
 
+  // Rewrite steps for rules that are not selected are still recorded, so that
+  // the sequence of rules applied can be recovered from a filtered trace.
+  auto *elided_block = llvm::BasicBlock::Create(
+      ctx_, "elided_rewrite_pre", true_block->getParent());
+  emit_write_uint64(outputFile, detail::word(0x44), elided_block);
+  emit_write_uint64(outputFile, axiom.get_ordinal(), elided_block);
+  llvm::BranchInst::Create(merge_block, elided_block);
+
+  if (!is_selected(axiom)) {
+    llvm::BranchInst::Create(elided_block, true_block);
+    return merge_block;
+  }
+
+  auto *full_block = llvm::BasicBlock::Create(
+      ctx_, "full_rewrite_pre", true_block->getParent());
+  llvm::BranchInst::Create(
+      full_block, elided_block,
+      emit_kind_enabled(proof_hint_kind::Rule, true_block), true_block);
+  true_block = full_block;
+
   emit_write_uint64(outputFile, detail::word(0x22), true_block);
   emit_write_uint64(outputFile, axiom.get_ordinal(), true_block);
   emit_write_uint64(outputFile, arity, true_block);
@@ -288,12 +385,12 @@ llvm::BasicBlock *proof_event::rewrite_event_post(
 llvm::BasicBlock *proof_event::function_event_pre(
     llvm::BasicBlock *current_block, kore_composite_pattern *pattern,
     std::string const &location_stack) {
-  if (!proof_hint_instrumentation) {
+  if (!proof_hint_instrumentation || !is_selected(pattern)) {
     return current_block;
   }
 
-  auto [true_block, merge_block, outputFile]
-      = event_prelude("function_pre", current_block);
+  auto [true_block, merge_block, outputFile] = event_prelude(
+      "function_pre", current_block, proof_hint_kind::Function);
 
   emit_write_uint64(outputFile, detail::word(0xDD), true_block);
   emit_write_string(
@@ -304,14 +401,14 @@ llvm::BasicBlock *proof_event::function_event_pre(
   return merge_block;
 }
 
-llvm::BasicBlock *
-proof_event::function_event_post(llvm::BasicBlock *current_block) {
-  if (!proof_hint_instrumentation) {
+llvm::BasicBlock *proof_event::function_event_post(
+    llvm::BasicBlock *current_block, kore_composite_pattern *pattern) {
+  if (!proof_hint_instrumentation || !is_selected(pattern)) {
     return current_block;
   }
 
-  auto [true_block, merge_block, outputFile]
-      = event_prelude("function_post", current_block);
+  auto [true_block, merge_block, outputFile] = event_prelude(
+      "function_post", current_block, proof_hint_kind::Function);
 
   emit_write_uint64(outputFile, detail::word(0x11), true_block);
 
@@ -323,12 +420,12 @@ proof_event::function_event_post(llvm::BasicBlock *current_block) {
 llvm::BasicBlock *proof_event::side_condition_event_pre(
     kore_axiom_declaration const &axiom, std::vector<llvm::Value *> const &args,
     llvm::BasicBlock *current_block) {
-  if (!proof_hint_instrumentation) {
+  if (!proof_hint_instrumentation || !is_selected(axiom)) {
     return current_block;
   }
 
-  auto [true_block, merge_block, outputFile]
-      = event_prelude("side_condition_pre", current_block);
+  auto [true_block, merge_block, outputFile] = event_prelude(
+      "side_condition_pre", current_block, proof_hint_kind::SideCondition);
 
   size_t ordinal = axiom.get_ordinal();
   size_t arity = args.size();
@@ -361,12 +458,12 @@ llvm::BasicBlock *proof_event::side_condition_event_pre(
 llvm::BasicBlock *proof_event::side_condition_event_post(
     kore_axiom_declaration const &axiom, llvm::Value *check_result,
     llvm::BasicBlock *current_block) {
-  if (!proof_hint_instrumentation) {
+  if (!proof_hint_instrumentation || !is_selected(axiom)) {
     return current_block;
   }
 
-  auto [true_block, merge_block, outputFile]
-      = event_prelude("side_condition_post", current_block);
+  auto [true_block, merge_block, outputFile] = event_prelude(
+      "side_condition_post", current_block, proof_hint_kind::SideCondition);
 
   size_t ordinal = axiom.get_ordinal();
 
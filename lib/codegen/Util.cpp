@@ -5,6 +5,7 @@
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
@@ -77,4 +78,15 @@ void insert_call_to_clear(llvm::BasicBlock *bb) {
   llvm::CallInst::Create(kore_clear, {}, "", bb);
 }
 
+void set_cold_successor(llvm::BranchInst *branch, unsigned idx) {
+  // The same ratio LLVM assumes for __builtin_expect.
+  uint32_t const hot_weight = 2000;
+  uint32_t const cold_weight = 1;
+  auto builder = llvm::MDBuilder(branch->getContext());
+  branch->setMetadata(
+      llvm::LLVMContext::MD_prof,
+      idx == 0 ? builder.createBranchWeights(cold_weight, hot_weight)
+               : builder.createBranchWeights(hot_weight, cold_weight));
+}
+
 } // namespace kllvm
@@ -95,6 +95,123 @@ sptr<kore_pattern> kore_parser::pattern() {
   return result;
 }
 
+// Parses a sort and returns it printed as by ast_to_string.
+std::string kore_parser::sort_text() {
+  std::string text = consume(token::Id);
+  if (peek() == token::LeftBrace) {
+    consume(token::LeftBrace);
+    text += "{";
+    if (peek() != token::RightBrace) {
+      text += sort_text();
+      while (peek() == token::Comma) {
+        consume(token::Comma);
+        text += "," + sort_text();
+      }
+    }
+    consume(token::RightBrace);
+    text += "}";
+  }
+  return text;
+}
+
+// Parses the sort arguments of the symbol with the specified name and returns
+// the symbol printed as by ast_to_string.
+std::string kore_parser::symbol_text(std::string const &name) {
+  std::string text = name + "{";
+  consume(token::LeftBrace);
+  if (peek() != token::RightBrace) {
+    text += sort_text();
+    while (peek() == token::Comma) {
+      consume(token::Comma);
+      text += ", " + sort_text();
+    }
+  }
+  consume(token::RightBrace);
+  return text + "}";
+}
+
+void kore_parser::pattern(pattern_handler &handler) {
+  enum class assoc { None, Left, Right };
+  struct application {
+    std::string symbol;
+    assoc kind;
+    size_t arity;
+  };
+  std::vector<application> stack;
+
+  while (true) {
+    // Set once a pattern has been parsed completely; argument is cleared if
+    // that pattern is an application with no arguments rather than the last
+    // argument of the innermost open application.
+    bool complete = false;
+    bool argument = true;
+    token current = peek();
+    switch (current) {
+    case token::String: {
+      handler.string(consume(token::String));
+      complete = true;
+      break;
+    }
+    case token::Id: {
+      std::string name = consume(token::Id);
+      if (peek() != token::LeftBrace) {
+        error(loc_, "Expected: { Actual: " + str(peek()));
+      }
+      if (name == "\\left-assoc" || name == "\\right-assoc") {
+        consume(token::LeftBrace);
+        consume(token::RightBrace);
+        consume(token::LeftParen);
+        auto kind = name == "\\left-assoc" ? assoc::Left : assoc::Right;
+        stack.push_back({symbol_text(consume(token::Id)), kind, 0});
+      } else {
+        stack.push_back({symbol_text(name), assoc::None, 0});
+      }
+      consume(token::LeftParen);
+      argument = peek() != token::RightParen;
+      complete = !argument;
+      break;
+    }
+    default: error(loc_, "Expected: [<id>, <string>] Actual: " + str(current));
+    }
+
+    while (complete && !stack.empty()) {
+      auto &app = stack.back();
+      if (argument) {
+        app.arity++;
+        if (app.kind == assoc::Left && app.arity > 1) {
+          handler.application(app.symbol, 2);
+        }
+        if (peek() == token::Comma) {
+          consume(token::Comma);
+          complete = false;
+          break;
+        }
+      }
+      consume(token::RightParen);
+      switch (app.kind) {
+      case assoc::None: handler.application(app.symbol, app.arity); break;
+      case assoc::Left:
+      case assoc::Right:
+        consume(token::RightParen);
+        if (app.arity == 0) {
+          error(loc_, "Expected: <pattern> Actual: )");
+        }
+        for (size_t i = 1; app.kind == assoc::Right && i < app.arity; ++i) {
+          handler.application(app.symbol, 2);
+        }
+        break;
+      }
+      stack.pop_back();
+      argument = true;
+    }
+
+    if (complete) {
+      consume(token::TokenEof);
+      return;
+    }
+  }
+}
+
 template <typename Node>
 void kore_parser::attributes(Node *node) {
   if (peek() == token::Id) {
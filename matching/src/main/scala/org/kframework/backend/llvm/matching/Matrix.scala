@@ -6,12 +6,14 @@ import com.runtimeverification.k.kore.Sort
 import com.runtimeverification.k.kore.SymbolOrAlias
 import com.runtimeverification.k.kore.Variable
 import java.util
+import java.util.concurrent.atomic.AtomicInteger
 import java.util.concurrent.ConcurrentHashMap
 import java.util.Optional
 import org.kframework.backend.llvm.matching.dt._
 import org.kframework.backend.llvm.matching.pattern._
 import scala.annotation.tailrec
 import scala.collection.immutable
+import scala.collection.parallel.CollectionConverters._
 
 trait AbstractColumn {
   def column: Column
@@ -604,18 +606,26 @@ class Matrix private (
     sigma.map(specialize(_, bestColIx, None))
 
   lazy val compiledCases: immutable.Seq[(String, immutable.Seq[String], DecisionTree)] = {
-    Matrix.remaining += sigma.length
+    Matrix.remaining.addAndGet(sigma.length)
     if (Matching.logging) {
       System.out.println("Signature:")
       System.out.println(sigma.map(_.toString).mkString("\n"))
     }
-    val result = cases.map { l =>
+    def compileCase(l: (String, immutable.Seq[String], Matrix)) = {
       if (Matching.logging) {
         System.out.println("Specializing by " + l._1)
       }
       (l._1, l._2, l._3.compile)
     }
-    Matrix.remaining -= sigma.length
+    // The cases of a large matrix are compiled concurrently. Subtrees they share
+    // are memoised in Matrix.cache and the nodes of the tree are hash-consed, so
+    // the result is the same tree as when compiling the cases in order.
+    val result =
+      if (sigma.length > 1 && rows.size >= Matrix.parallelThreshold)
+        cases.par.map(compileCase).toList
+      else
+        cases.map(compileCase)
+    Matrix.remaining.addAndGet(-sigma.length)
     result
   }
 
@@ -686,9 +696,9 @@ class Matrix private (
     }
 
   lazy val compiledDefault: Option[DecisionTree] = {
-    Matrix.remaining += 1
+    Matrix.remaining.incrementAndGet()
     val result = default(bestColIx, sigma).map(_.compile)
-    Matrix.remaining -= 1
+    Matrix.remaining.decrementAndGet()
     result
   }
 
@@ -881,7 +891,7 @@ class Matrix private (
       val s = toString
       System.out.println("-- Compile --")
       System.out.println(s)
-      System.out.println("remaining: " + Matrix.remaining)
+      System.out.println("remaining: " + Matrix.remaining.get)
     }
     if (clauses.isEmpty)
       Failure()
@@ -1140,7 +1150,7 @@ class Matrix private (
           .mkString(" ")
       )
       System.out.println(toString)
-      System.out.println("remaining: " + Matrix.remaining)
+      System.out.println("remaining: " + Matrix.remaining.get)
     }
     if (clauses.isEmpty || columns.indices.forall(i => isWildcardOrResidual(ps(i)))) {
       (this, ps)
@@ -1213,7 +1223,11 @@ class Matrix private (
 }
 
 object Matrix {
-  var remaining = 0
+  val remaining = new AtomicInteger()
+
+  // Matrices with at least this many rows compile their cases in parallel;
+  // below it, the cost of scheduling the work outweighs the gain.
+  val parallelThreshold = 64
 
   def fromRows(
       symlib: Parser.SymLib,
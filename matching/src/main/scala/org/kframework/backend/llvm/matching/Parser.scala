@@ -3,6 +3,7 @@ package org.kframework.backend.llvm.matching
 import com.runtimeverification.k.kore._
 import com.runtimeverification.k.kore.implementation.{ DefaultBuilders => B }
 import java.util
+import java.util.concurrent.ConcurrentHashMap
 import java.util.Optional
 import scala.collection.immutable
 
@@ -54,7 +55,7 @@ object Parser {
       overloadSeq: immutable.Seq[(SymbolOrAlias, SymbolOrAlias)],
       val heuristics: immutable.Seq[Heuristic]
   ) {
-    val sortCache = new util.HashMap[Sort, SortInfo]()
+    val sortCache = new ConcurrentHashMap[Sort, SortInfo]()
 
     private val symbolDecls = mod.modules
       .flatMap(_.decls)
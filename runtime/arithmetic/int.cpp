@@ -1,3 +1,4 @@
+#include <array>
 #include <cstdlib>
 #include <cstring>
 #include <gmp.h>
@@ -5,8 +6,46 @@
 
 #include "runtime/header.h"
 
+namespace {
+
+// Ints in this range returned by a hook are shared rather than allocated.
+constexpr long small_int_min = -256;
+constexpr long small_int_max = 1024;
+constexpr size_t num_small_ints = small_int_max - small_int_min + 1;
+
+// Like Int literals in the static term, the cached Ints are neither young nor
+// old, so the garbage collector never moves them.
+struct small_int_cache {
+  std::array<mpz_hdr, num_small_ints> ints{};
+  std::array<mp_limb_t, num_small_ints> limbs{};
+
+  small_int_cache() {
+    for (size_t idx = 0; idx < num_small_ints; ++idx) {
+      long value = small_int_min + (long)idx;
+      limbs[idx] = value < 0 ? -value : value;
+      ints[idx].h.hdr
+          = (sizeof(mpz_hdr) - sizeof(blockheader)) | NOT_YOUNG_OBJECT_BIT;
+      ints[idx].i->_mp_alloc = 1;
+      ints[idx].i->_mp_size = value < 0 ? -1 : value > 0;
+      ints[idx].i->_mp_d = &limbs[idx];
+    }
+  }
+};
+
+} // namespace
+
 extern "C" {
 
+mpz_ptr small_int(mpz_t i) {
+  if (mpz_cmp_si(i, small_int_min) < 0 || mpz_cmp_si(i, small_int_max) > 0) {
+    return nullptr;
+  }
+  static small_int_cache cache;
+  long value = mpz_get_si(i);
+  mpz_clear(i);
+  return cache.ints[value - small_int_min].i;
+}
+
 void add_hash64(void *, uint64_t);
 
 SortInt hook_INT_tmod(SortInt a, SortInt b) {
@@ -426,6 +465,23 @@ size_t *hook_MINT_export(mpz_t in, uint64_t bits) {
   return resultptr;
 }
 
+void int_low_words(mpz_t in, uint64_t *out, uint64_t nwords) {
+  // Negative values are written in two's complement, by negating their
+  // magnitude one word at a time.
+  bool negative = mpz_sgn(in) < 0;
+  bool carry = true;
+  size_t size = mpz_size(in);
+  for (uint64_t i = 0; i < nwords; ++i) {
+    uint64_t word = i < size ? mpz_getlimbn(in, i) : 0;
+    if (negative) {
+      uint64_t negated = ~word + carry;
+      carry = carry && word == 0;
+      word = negated;
+    }
+    out[i] = word;
+  }
+}
+
 mpz_ptr hook_MINT_import(size_t *i, uint64_t bits, bool is_signed) {
   mpz_t result;
   mpz_t twos;
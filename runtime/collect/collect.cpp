@@ -8,6 +8,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
+#include <vector>
 
 extern "C" {
 
@@ -18,6 +20,7 @@ char *oldspace_ptr(void);
 
 static bool is_gc = false;
 bool collect_old = false;
+bool promote_young = false;
 #ifndef GC_DBG
 static uint8_t num_collection_only_young = 0;
 #else
@@ -33,6 +36,20 @@ bool during_gc() {
   return is_gc;
 }
 
+// Ropes are not symbols of the definition, so their layout is not known to
+// the generated get_layout_data; both children are strings or ropes.
+static layoutitem rope_layout_items[]
+    = {{offsetof(rope, left), SYMBOL_LAYOUT},
+       {offsetof(rope, right), SYMBOL_LAYOUT}};
+static layout rope_layout = {2, rope_layout_items};
+
+static layout *get_layout_data_for_gc(uint16_t layout_int) {
+  if (layout_int == ROPE_LAYOUT) {
+    return &rope_layout;
+  }
+  return get_layout_data(layout_int);
+}
+
 size_t get_size(uint64_t hdr, uint16_t layout) {
   if (!layout) {
     size_t size = (len_hdr(hdr) + sizeof(blockheader) + 7) & ~7;
@@ -45,7 +62,7 @@ uint8_t get_first_field_offset(uint16_t layout_int) {
   if (!layout_int) {
     return 1;
   }
-  layout *layout_data = get_layout_data(layout_int);
+  layout *layout_data = get_layout_data_for_gc(layout_int);
   return layout_data->args[0].offset / 8;
 }
 
@@ -67,6 +84,9 @@ void migrate(block **block_ptr) {
     } else {
       new_block = (block *)kore_alloc(len_in_bytes);
     }
+    if (shouldPromote && layout) {
+      record_promotion(hdr);
+    }
 #ifdef GC_DBG
     numBytesLiveAtCollection[oldAge] += len_in_bytes;
 #endif
@@ -248,12 +268,27 @@ static void migrate_root(void *curr_block, layoutitem *args, unsigned i) {
   }
 }
 
+// Globals caching the results of function calls hoisted out of rules by the
+// code generator, together with the layout category of the cached value.
+static std::vector<std::pair<void *, uint16_t>> hoisted_roots;
+
+void register_hoisted_root(void *root, uint16_t cat) {
+  hoisted_roots.emplace_back(root, cat);
+}
+
+void migrate_hoisted_roots() {
+  for (auto [root, cat] : hoisted_roots) {
+    layoutitem item = {0, cat};
+    migrate_child(root, &item, 0, true);
+  }
+}
+
 static char *evacuate(char *scan_ptr, char **alloc_ptr) {
   auto *curr_block = (block *)scan_ptr;
   uint64_t const hdr = curr_block->h.hdr;
   uint16_t layout_int = layout_hdr(hdr);
   if (layout_int) {
-    layout *layout_data = get_layout_data(layout_int);
+    layout *layout_data = get_layout_data_for_gc(layout_int);
     for (unsigned i = 0; i < layout_data->nargs; i++) {
       migrate_child(curr_block, layout_data->args, i, false);
     }
@@ -261,6 +296,48 @@ static char *evacuate(char *scan_ptr, char **alloc_ptr) {
   return move_ptr(scan_ptr, get_size(hdr, layout_int), *alloc_ptr);
 }
 
+// Returns the address of the first object allocated into the old generation
+// after its allocation pointer had the specified value.
+static char *oldspace_scan_start(char *previous_oldspace_alloc_ptr) {
+  if (MEM_BLOCK_START(previous_oldspace_alloc_ptr + 1)
+      == previous_oldspace_alloc_ptr) {
+    // this means that the previous oldspace allocation pointer points to an
+    // address that is megabyte-aligned. This can only happen if we have just
+    // filled up a block but have not yet allocated the next block in the
+    // sequence at the start of the collection cycle. This means that the
+    // allocation pointer is invalid and does not actually point to the next
+    // address that would have been allocated at, according to the logic of
+    // kore_arena_alloc, which will have allocated a fresh memory block and put
+    // the allocation at the start of it. Thus, we use move_ptr with a size
+    // of zero to adjust and get the true address of the allocation.
+    return move_ptr(previous_oldspace_alloc_ptr, 0, *old_alloc_ptr());
+  }
+  return previous_oldspace_alloc_ptr;
+}
+
+// Pretenured blocks are old but may point to young terms, which a young
+// generation collection assumes old terms never do. So before any roots are
+// migrated, everything young they reach is promoted, and the promoted terms
+// are scanned in turn until no young term is reachable from the old
+// generation.
+static void migrate_pretenured_blocks() {
+  char *previous_oldspace_alloc_ptr = *old_alloc_ptr();
+  promote_young = true;
+  for (auto *pretenured : pretenured_blocks) {
+    evacuate((char *)pretenured, old_alloc_ptr());
+  }
+  char *scan_ptr = previous_oldspace_alloc_ptr
+                       ? oldspace_scan_start(previous_oldspace_alloc_ptr)
+                       : oldspace_ptr();
+  if (scan_ptr != *old_alloc_ptr()) {
+    while (scan_ptr) {
+      scan_ptr = evacuate(scan_ptr, old_alloc_ptr());
+    }
+  }
+  promote_young = false;
+  pretenured_blocks.clear();
+}
+
 // Contains the decision logic for collecting the old generation.
 // For now, we collect the old generation every 50 young generation collections.
 static bool should_collect_old_gen() {
@@ -299,6 +376,15 @@ void kore_collect(void **roots, uint8_t nroots, layoutitem *type_info) {
     numBytesLiveAtCollection[i] = 0;
   }
 #endif
+  // An old generation collection copies every live pretenured block, and
+  // everything it reaches, from the roots; treating the blocks as roots would
+  // keep the dead ones alive.
+  if (collect_old) {
+    pretenured_blocks.clear();
+  } else if (!pretenured_blocks.empty()) {
+    MEM_LOG("Promoting terms reachable from pretenured blocks\n");
+    migrate_pretenured_blocks();
+  }
   char *previous_oldspace_alloc_ptr = *old_alloc_ptr();
   for (int i = 0; i < nroots; i++) {
     migrate_root(roots, type_info, i);
@@ -314,21 +400,7 @@ void kore_collect(void **roots, uint8_t nroots, layoutitem *type_info) {
   if (collect_old || !previous_oldspace_alloc_ptr) {
     scan_ptr = oldspace_ptr();
   } else {
-    if (MEM_BLOCK_START(previous_oldspace_alloc_ptr + 1)
-        == previous_oldspace_alloc_ptr) {
-      // this means that the previous oldspace allocation pointer points to an
-      // address that is megabyte-aligned. This can only happen if we have just
-      // filled up a block but have not yet allocated the next block in the
-      // sequence at the start of the collection cycle. This means that the
-      // allocation pointer is invalid and does not actually point to the next
-      // address that would have been allocated at, according to the logic of
-      // kore_arena_alloc, which will have allocated a fresh memory block and put
-      // the allocation at the start of it. Thus, we use move_ptr with a size
-      // of zero to adjust and get the true address of the allocation.
-      scan_ptr = move_ptr(previous_oldspace_alloc_ptr, 0, *old_alloc_ptr());
-    } else {
-      scan_ptr = previous_oldspace_alloc_ptr;
-    }
+    scan_ptr = oldspace_scan_start(previous_oldspace_alloc_ptr);
   }
   if (scan_ptr != *old_alloc_ptr()) {
     MEM_LOG("Evacuating old generation\n");
@@ -350,6 +422,7 @@ void kore_collect(void **roots, uint8_t nroots, layoutitem *type_info) {
   MEM_LOG("Finishing garbage collection\n");
   is_gc = false;
   set_gc_threshold(youngspace_size());
+  update_pretenured_tags();
 }
 
 void free_all_kore_mem() {
@@ -24,6 +24,7 @@ void migrate_static_roots() {
     migrate((block **)&limbs);
     rand = (mp_limb_t *)limbs->data;
   }
+  migrate_hoisted_roots();
   if (block_enumerators.empty()) {
     return;
   }
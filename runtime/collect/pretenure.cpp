@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "runtime/alloc.h"
+#include "runtime/collect.h"
+#include "runtime/header.h"
+
+namespace {
+
+// A tag allocated through kore_alloc_adaptive is pretenured once at least this
+// many blocks with that tag have been allocated...
+constexpr uint64_t pretenure_min_allocations = 4096;
+
+// ...and at least this percentage of them have been promoted to the old
+// generation.
+constexpr uint64_t pretenure_min_survival_percent = 50;
+
+struct pretenure_stats {
+  uint64_t allocations = 0;
+  uint64_t promotions = 0;
+  bool pretenured = false;
+};
+
+// Indexed by tag; only tags allocated through kore_alloc_adaptive have entries.
+std::vector<pretenure_stats> stats;
+
+// If KLLVM_PRETENURE_PROFILE is set, tags are never pretenured at run time;
+// instead, the survival rate of each tag is written to the file it names on
+// exit, for use with llvm-kompile --pretenure-profile.
+char const *profile_path() {
+  static char const *path = getenv("KLLVM_PRETENURE_PROFILE");
+  return path;
+}
+
+void write_profile() {
+  FILE *file = fopen(profile_path(), "w");
+  if (!file) {
+    perror("KLLVM_PRETENURE_PROFILE");
+    return;
+  }
+  for (uint32_t tag = 0; tag < stats.size(); ++tag) {
+    if (stats[tag].allocations) {
+      fprintf(
+          file, "%s %llu %llu\n", get_symbol_name_for_tag(tag),
+          (unsigned long long)stats[tag].allocations,
+          (unsigned long long)stats[tag].promotions);
+    }
+  }
+  fclose(file);
+}
+
+pretenure_stats &stats_for_tag(uint64_t tag) {
+  if (tag >= stats.size()) {
+    if (stats.empty() && profile_path()) {
+      atexit(write_profile);
+    }
+    stats.resize(tag + 1);
+  }
+  return stats[tag];
+}
+
+} // namespace
+
+std::vector<block *> pretenured_blocks;
+
+extern "C" {
+
+void *kore_alloc_pretenured(size_t requested, uint64_t hdr) {
+  auto *result = static_cast<block *>(kore_alloc_old(requested));
+  result->h.hdr = hdr | NOT_YOUNG_OBJECT_BIT | AGE_MASK;
+  pretenured_blocks.push_back(result);
+  return result;
+}
+
+void *kore_alloc_adaptive(size_t requested, uint64_t hdr) {
+  auto &tag_stats = stats_for_tag(tag_hdr(hdr));
+  tag_stats.allocations++;
+  if (tag_stats.pretenured) {
+    return kore_alloc_pretenured(requested, hdr);
+  }
+  auto *result = static_cast<block *>(kore_alloc(requested));
+  result->h.hdr = hdr;
+  return result;
+}
+
+void record_promotion(uint64_t hdr) {
+  // Terms reachable from pretenured blocks are promoted regardless of their
+  // age, so they say nothing about how long terms with their tag survive.
+  if (promote_young) {
+    return;
+  }
+  uint64_t tag = tag_hdr(hdr);
+  if (tag < stats.size()) {
+    stats[tag].promotions++;
+  }
+}
+
+void update_pretenured_tags() {
+  if (profile_path()) {
+    return;
+  }
+  for (auto &tag_stats : stats) {
+    if (!tag_stats.pretenured
+        && tag_stats.allocations >= pretenure_min_allocations
+        && tag_stats.promotions * 100
+               >= tag_stats.allocations * pretenure_min_survival_percent) {
+      tag_stats.pretenured = true;
+    }
+  }
+}
+}
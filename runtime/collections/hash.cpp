@@ -65,6 +65,10 @@ void k_hash(block *arg, void *h) {
     auto argintptr = (uint64_t)arg;
     if (is_leaf_block(arg)) {
       add_hash64(h, argintptr);
+    } else if (is_rope(arg)) {
+      // Ropes must hash like the flat strings they stand for.
+      auto *str = flatten_string((string *)arg);
+      add_hash_str(h, str->data, len(str));
     } else {
       uint64_t arghdrcanon = arg->h.hdr & HDR_MASK;
       if (uint16_t arglayout = get_layout(arg)) {
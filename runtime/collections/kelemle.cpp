@@ -11,6 +11,13 @@ bool hook_STRING_lt(SortString, SortString);
 
 // NOLINTNEXTLINE(*-cognitive-complexity)
 bool hook_KEQUAL_eq(block *arg1, block *arg2) {
+  // Collections that share structure, such as a map and a copy of it with one
+  // key updated, also share the terms stored in them. Immer already skips
+  // inner nodes the two collections have in common, so this check makes the
+  // elements of the remaining nodes cheap to compare as well.
+  if (arg1 == arg2) {
+    return true;
+  }
   auto arg1intptr = (uint64_t)arg1;
   auto arg2intptr = (uint64_t)arg2;
   bool arg1lb = is_leaf_block(arg1);
@@ -20,6 +27,12 @@ bool hook_KEQUAL_eq(block *arg1, block *arg2) {
       // Both arg1 and arg2 are constants.
       return arg1intptr == arg2intptr;
     } // Both arg1 and arg2 are blocks.
+    if (is_rope(arg1) || is_rope(arg2)) {
+      // Ropes compare equal to the flat strings they stand for.
+      return hook_KEQUAL_eq(
+          (block *)flatten_string((string *)arg1),
+          (block *)flatten_string((string *)arg2));
+    }
     uint64_t arg1hdrcanon = arg1->h.hdr & HDR_MASK;
     uint64_t arg2hdrcanon = arg2->h.hdr & HDR_MASK;
     if (arg1hdrcanon == arg2hdrcanon) {
@@ -158,6 +171,11 @@ bool hook_KEQUAL_lt(block *arg1, block *arg2) {
     // Both arg1 and arg2 are constants.
     return arg1intptr < arg2intptr;
   } // Both arg1 and arg2 are blocks.
+  if (is_rope(arg1) || is_rope(arg2)) {
+    return hook_KEQUAL_lt(
+        (block *)flatten_string((string *)arg1),
+        (block *)flatten_string((string *)arg2));
+  }
   uint16_t arg1layout = get_layout(arg1);
   uint16_t arg2layout = get_layout(arg2);
   if (arg1layout == 0 && arg2layout == 0) {
@@ -1,6 +1,7 @@
 #include "runtime/header.h"
 
 #include "immer/flex_vector_transient.hpp"
+#include "immer/set_transient.hpp"
 
 extern "C" {
 mapiter map_iterator(map *map) {
@@ -80,17 +81,14 @@ map hook_MAP_difference(SortMap m1, SortMap m2) {
   return to;
 }
 
-set hook_SET_unit(void);
-set hook_SET_element(block *);
-set hook_SET_concat(set *, set *);
-
 set hook_MAP_keys(SortMap m) {
-  auto tmp = hook_SET_unit();
+  // The keys of a map are already distinct, so they can be inserted into a
+  // transient set in place rather than copying a path of the set per key.
+  auto tmp = set().transient();
   for (auto iter = m->begin(); iter != m->end(); ++iter) {
-    auto elem = hook_SET_element(iter->first);
-    tmp = hook_SET_concat(&tmp, &elem);
+    tmp.insert(iter->first);
   }
-  return tmp;
+  return tmp.persistent();
 }
 
 list hook_MAP_keys_list(SortMap m) {
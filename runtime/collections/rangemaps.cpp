@@ -1,6 +1,7 @@
 #include "runtime/header.h"
 
 #include "immer/flex_vector_transient.hpp"
+#include "immer/set_transient.hpp"
 
 extern "C" {
 rangemap
@@ -97,10 +98,6 @@ rangemap hook_RANGEMAP_difference(SortRangeMap m1, SortRangeMap m2) {
   return m1->difference(*m2);
 }
 
-set hook_SET_unit(void);
-set hook_SET_element(block *);
-set hook_SET_concat(set *, set *);
-
 struct inj_range2kitem {
   blockheader h;
   range *child;
@@ -114,7 +111,7 @@ static struct blockheader inj_range2kitem_header() {
   return hdr;
 }
 set hook_RANGEMAP_keys(SortRangeMap m) {
-  auto tmp = hook_SET_unit();
+  auto tmp = set().transient();
   for (auto iter = rng_map::ConstRangeMapIterator<k_elem, k_elem>(*m);
        iter.has_next(); ++iter) {
     auto *ptr = (range *)kore_alloc(sizeof(range));
@@ -124,10 +121,9 @@ set hook_RANGEMAP_keys(SortRangeMap m) {
     auto *inj_ptr = (inj_range2kitem *)kore_alloc(sizeof(inj_range2kitem));
     inj_ptr->h = inj_range2kitem_header();
     inj_ptr->child = ptr;
-    auto elem = hook_SET_element((SortKItem)inj_ptr);
-    tmp = hook_SET_concat(&tmp, &elem);
+    tmp.insert((SortKItem)inj_ptr);
   }
-  return tmp;
+  return tmp.persistent();
 }
 
 list hook_RANGEMAP_keys_list(SortRangeMap m) {
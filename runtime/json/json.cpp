@@ -224,7 +224,8 @@ static bool write_json(kore_writer<Stream> &writer, block *data) {
       writer.raw_number(str.c_str(), str.length(), false);
     } else if (tag_hdr(data->h.hdr) == tag_hdr(strHdr().hdr)) {
       auto *inj = (stringinj *)data;
-      writer.String(inj->data->data, len(inj->data), false);
+      auto *str = flatten_string(inj->data);
+      writer.String(str->data, len(str), false);
     } else if (tag_hdr(data->h.hdr) == tag_hdr(objHdr().hdr)) {
       writer.StartObject();
       json *obj = (json *)data;
@@ -242,7 +243,8 @@ static bool write_json(kore_writer<Stream> &writer, block *data) {
     } else if (tag_hdr(data->h.hdr) == tag_hdr(membHdr().hdr)) {
       auto *memb = (jsonmember *)data;
       auto *inj = (stringinj *)memb->key;
-      writer.Key(inj->data->data, len(inj->data), false);
+      auto *str = flatten_string(inj->data);
+      writer.Key(str->data, len(str), false);
       return_value = write_json(writer, memb->val);
     } else {
       return_value = false;
@@ -18,12 +18,14 @@ declare void @print_proof_hint_header(i8*)
 @statistics.flag = private constant [13 x i8] c"--statistics\00"
 @binary_out.flag = private constant [16 x i8] c"--binary-output\00"
 @proof_out.flag = private constant [15 x i8] c"--proof-output\00"
+@proof_mask.flag = private constant [18 x i8] c"--proof-hint-mask\00"
 
 @output_file = external global i8*
 @a_str = private constant [2 x i8] c"a\00"
 @statistics = external global i1
 @binary_output = external global i1
 @proof_output = external global i1
+@proof_hint_mask = external global i64
 
 declare i32 @strcmp(i8* %a, i8* %b)
 
@@ -63,17 +65,33 @@ binary.set:
 proof.body:
   %proof.cmp = call i32 @strcmp(i8* %arg, i8* getelementptr inbounds ([15 x i8], [15 x i8]* @proof_out.flag, i64 0, i64 0))
   %proof.eq = icmp eq i32 %proof.cmp, 0
-  br i1 %proof.eq, label %proof.set, label %body.tail
+  br i1 %proof.eq, label %proof.set, label %mask.body
 
 proof.set:
   store i1 1, i1* @proof_output
+  br label %mask.body
+
+mask.body:
+  %mask.cmp = call i32 @strcmp(i8* %arg, i8* getelementptr inbounds ([18 x i8], [18 x i8]* @proof_mask.flag, i64 0, i64 0))
+  %mask.eq = icmp eq i32 %mask.cmp, 0
+  %mask.idx = add i32 %idx, 1
+  %mask.has_arg = icmp slt i32 %mask.idx, %argc
+  %mask.found = and i1 %mask.eq, %mask.has_arg
+  br i1 %mask.found, label %mask.set, label %body.tail
+
+mask.set:
+  %mask.argv.idx = getelementptr inbounds i8*, i8** %argv, i32 %mask.idx
+  %mask.arg = load i8*, i8** %mask.argv.idx
+  %mask = call i64 @atol(i8* %mask.arg)
+  store i64 %mask, i64* @proof_hint_mask
   br label %body.tail
 
 body.tail:
+  %step = phi i32 [ 1, %mask.body ], [ 2, %mask.set ]
   br label %inc
 
 inc:
-  %idx.inc = add i32 %idx, 1
+  %idx.inc = add i32 %idx, %step
   br label %header
 
 exit:
@@ -9,7 +9,8 @@ uint64_t get_steps(void);
 }
 
 std::unordered_set<block *, hash_block, k_eq> take_search_steps(
-    bool executeToBranch, int64_t depth, int64_t bound, block *subject);
+    bool executeToBranch, int64_t depth, int64_t bound, bool memoizeSuccessors,
+    block *subject);
 void print_configurations(
     FILE *file, std::unordered_set<block *, hash_block, k_eq> results);
 
@@ -19,6 +20,7 @@ void serialize_configurations(
 static bool hasStatistics = false;
 static bool binaryOutput = false;
 static bool executeToBranch = false;
+static bool memoizeSuccessors = false;
 static int64_t bound = -1;
 
 void parse_flags(int argc, char **argv) {
@@ -36,6 +38,9 @@ void parse_flags(int argc, char **argv) {
     if (strcmp(argv[i], "--execute-to-branch") == 0) {
       executeToBranch = true;
     }
+    if (strcmp(argv[i], "--memoize-successors") == 0) {
+      memoizeSuccessors = true;
+    }
   }
 }
 
@@ -50,7 +55,8 @@ int main(int argc, char **argv) {
 
   block *input = parse_configuration(filename);
   std::unordered_set<block *, hash_block, k_eq> results
-      = take_search_steps(executeToBranch, depth, bound, input);
+      = take_search_steps(
+          executeToBranch, depth, bound, memoizeSuccessors, input);
   FILE *file = fopen(output, "w");
   if (hasStatistics) {
     print_statistics(file, get_steps());
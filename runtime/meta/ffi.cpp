@@ -3,11 +3,12 @@
 #include <ffi.h>
 #include <gmp.h>
 #include <map>
-#include <stdexcept>
+#include <memory>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "runtime/alloc.h"
@@ -30,9 +31,47 @@ extern "C" {
 
 thread_local static std::vector<ffi_type *> struct_types;
 
-static std::unordered_map<block *, string *, hash_block, k_eq>
-    allocated_k_item_ptrs;
-static std::map<string *, block *> allocated_bytes_refs;
+// Memory allocated by hook_FFI_alloc, together with the K item naming it.
+struct ffi_allocation {
+  // Must be the first member; see remove_root.
+  block *kitem;
+  string *bytes;
+  // The structural hash of kitem, computed once when the memory is allocated.
+  size_t hash;
+  // The position of &kitem in ffi_roots if kitem is on the K heap.
+  size_t root_index;
+};
+
+struct ffi_allocation_hash {
+  size_t operator()(ffi_allocation const *alloc) const noexcept {
+    return alloc->hash;
+  }
+};
+
+struct ffi_allocation_eq {
+  bool
+  operator()(ffi_allocation const *lhs, ffi_allocation const *rhs) const {
+    return lhs->kitem == rhs->kitem || hook_KEQUAL_eq(lhs->kitem, rhs->kitem);
+  }
+};
+
+// Allocations named by a constant are found by the identity of its leaf
+// block; only those named by a term on the K heap are hashed structurally.
+// The latter refer to their K item through the allocation itself, so the
+// table stays valid when the garbage collector moves the item.
+static std::unordered_map<block *, ffi_allocation *> leaf_allocations;
+static std::unordered_set<
+    ffi_allocation *, ffi_allocation_hash, ffi_allocation_eq>
+    term_allocations;
+
+// Owns every allocation, indexed by the memory handed out for it.
+static std::unordered_map<string *, std::unique_ptr<ffi_allocation>>
+    allocations_by_bytes;
+
+// The K items on the K heap that name an allocation. This is kept up to date
+// as memory is allocated and freed, so that a collection does not need to
+// walk the tables above to find its roots.
+static std::vector<block **> ffi_roots;
 
 TAG_TYPE(void)
 TAG_TYPE(uint8)
@@ -342,42 +381,35 @@ SortInt hook_FFI_address(SortString fn) {
 
 static std::pair<
     std::vector<block **>::iterator, std::vector<block **>::iterator>
-first_block_enumerator() {
-  // NOLINTBEGIN(*-const-cast)
-  static std::vector<block **> blocks;
-
-  blocks.clear();
+ffi_roots_enumerator() {
+  return std::make_pair(ffi_roots.begin(), ffi_roots.end());
+}
 
-  for (auto &key_val : allocated_k_item_ptrs) {
-    blocks.push_back(const_cast<block **>(&(key_val.first)));
+static ffi_allocation *find_allocation(block *kitem) {
+  if (is_leaf_block(kitem)) {
+    auto it = leaf_allocations.find(kitem);
+    return it == leaf_allocations.end() ? nullptr : it->second;
   }
 
-  return std::make_pair(blocks.begin(), blocks.end());
-  // NOLINTEND(*-const-cast)
+  ffi_allocation key{kitem, nullptr, hash_k(kitem), 0};
+  auto it = term_allocations.find(&key);
+  return it == term_allocations.end() ? nullptr : *it;
 }
 
-static std::pair<
-    std::vector<block **>::iterator, std::vector<block **>::iterator>
-second_block_enumerator() {
-  // NOLINTBEGIN(*-const-cast)
-  static std::vector<block **> blocks;
-
-  blocks.clear();
-
-  for (auto &key_val : allocated_bytes_refs) {
-    blocks.push_back(const_cast<block **>(&(key_val.second)));
-  }
-
-  return std::make_pair(blocks.begin(), blocks.end());
-  // NOLINTEND(*-const-cast)
+static void remove_root(ffi_allocation *alloc) {
+  block **last = ffi_roots.back();
+  ffi_roots[alloc->root_index] = last;
+  // kitem is the first member of ffi_allocation, so last also points to the
+  // allocation it belongs to.
+  reinterpret_cast<ffi_allocation *>(last)->root_index = alloc->root_index;
+  ffi_roots.pop_back();
 }
 
 string *hook_FFI_alloc(block *kitem, mpz_t size, mpz_t align) {
   static int registered = -1;
 
   if (registered == -1) {
-    register_gc_roots_enumerator(first_block_enumerator);
-    register_gc_roots_enumerator(second_block_enumerator);
+    register_gc_roots_enumerator(ffi_roots_enumerator);
     registered = 0;
   }
 
@@ -391,12 +423,12 @@ string *hook_FFI_alloc(block *kitem, mpz_t size, mpz_t align) {
 
   size_t a = mpz_get_ui(align);
 
-  if (allocated_k_item_ptrs.find(kitem) != allocated_k_item_ptrs.end()) {
-    string *result = allocated_k_item_ptrs[kitem];
+  if (ffi_allocation *alloc = find_allocation(kitem)) {
+    string *result = alloc->bytes;
     if ((((uintptr_t)result) & (a - 1)) != 0) {
       KLLVM_HOOK_INVALID_ARGUMENT("Memory is not aligned");
     }
-    return allocated_k_item_ptrs[kitem];
+    return result;
   }
 
   size_t s = mpz_get_ui(size);
@@ -412,46 +444,60 @@ string *hook_FFI_alloc(block *kitem, mpz_t size, mpz_t align) {
   init_with_len(ret, s);
   ret->h.hdr |= NOT_YOUNG_OBJECT_BIT;
 
-  allocated_k_item_ptrs[kitem] = ret;
-  allocated_bytes_refs[ret] = kitem;
+  auto alloc = std::make_unique<ffi_allocation>(
+      ffi_allocation{kitem, ret, 0, ffi_roots.size()});
+  if (is_leaf_block(kitem)) {
+    leaf_allocations[kitem] = alloc.get();
+  } else {
+    alloc->hash = hash_k(kitem);
+    term_allocations.insert(alloc.get());
+    ffi_roots.push_back(&alloc->kitem);
+  }
+  allocations_by_bytes[ret] = std::move(alloc);
 
   return ret;
 }
 
 block *hook_FFI_free(block *kitem) {
-  auto ptr_iter = allocated_k_item_ptrs.find(kitem);
-  auto ref_iter = allocated_bytes_refs.find(ptr_iter->second);
-
-  if (ptr_iter != allocated_k_item_ptrs.end()) {
-    free(allocated_k_item_ptrs[kitem]);
-    allocated_k_item_ptrs.erase(ptr_iter);
+  ffi_allocation *alloc = find_allocation(kitem);
 
-    if (ref_iter != allocated_bytes_refs.end()) {
-      allocated_bytes_refs.erase(ref_iter);
+  if (alloc) {
+    if (is_leaf_block(alloc->kitem)) {
+      leaf_allocations.erase(alloc->kitem);
     } else {
-      throw std::runtime_error("Internal memory map is out of sync");
+      term_allocations.erase(alloc);
+      remove_root(alloc);
     }
+
+    string *bytes = alloc->bytes;
+    allocations_by_bytes.erase(bytes);
+    free(bytes);
   }
 
   return dot_k();
 }
 
 block *hook_FFI_freeAll(void) {
-  for (auto &allocated_k_item_ptr : allocated_k_item_ptrs) {
-    hook_FFI_free(allocated_k_item_ptr.first);
+  for (auto &[bytes, alloc] : allocations_by_bytes) {
+    free(bytes);
   }
 
+  leaf_allocations.clear();
+  term_allocations.clear();
+  allocations_by_bytes.clear();
+  ffi_roots.clear();
+
   return dot_k();
 }
 
 block *hook_FFI_bytes_ref(string *bytes) {
-  auto ref_iter = allocated_bytes_refs.find(bytes);
+  auto ref_iter = allocations_by_bytes.find(bytes);
 
-  if (ref_iter == allocated_bytes_refs.end()) {
+  if (ref_iter == allocations_by_bytes.end()) {
     KLLVM_HOOK_INVALID_ARGUMENT("Bytes have no reference");
   }
 
-  return allocated_bytes_refs[bytes];
+  return ref_iter->second->kitem;
 }
 
 mpz_ptr hook_FFI_bytes_address(string *bytes) {
@@ -461,7 +507,7 @@ mpz_ptr hook_FFI_bytes_address(string *bytes) {
 }
 
 bool hook_FFI_allocated(block *kitem) {
-  return allocated_k_item_ptrs.find(kitem) != allocated_k_item_ptrs.end();
+  return find_allocation(kitem) != nullptr;
 }
 
 SortK hook_FFI_read(SortInt addr, SortBytes mem) {
@@ -39,7 +39,7 @@ block *debruijnize_internal(block *curr_block) {
   }
   uint64_t const hdr = curr_block->h.hdr;
   uint16_t layout_int = layout_hdr(hdr);
-  if (layout_int) {
+  if (layout_int && layout_int != ROPE_LAYOUT) {
     uint32_t tag = tag_hdr(hdr);
     bool is_binder = is_symbol_a_binder(tag);
     if (is_binder) {
@@ -120,7 +120,7 @@ block *replace_binder_internal(block *curr_block) {
   }
   uint64_t const hdr = curr_block->h.hdr;
   uint16_t layout_int = layout_hdr(hdr);
-  if (layout_int) {
+  if (layout_int && layout_int != ROPE_LAYOUT) {
     uint32_t tag = tag_hdr(hdr);
     bool is_binder = is_symbol_a_binder(tag);
     if (is_binder) {
@@ -186,7 +186,7 @@ block *substitute_internal(block *curr_block) {
   uint16_t layout_int = layout_hdr(hdr);
   if (hook_KEQUAL_eq(curr_block, to_replace)) {
     idx2 = 0;
-    if (layout_int) {
+    if (layout_int && layout_int != ROPE_LAYOUT) {
       uint32_t tag = tag_hdr(hdr);
       uint32_t inj_tag = get_injection_for_sort_of_tag(tag);
       if (tag_hdr(replacement_inj->h.hdr) != inj_tag) {
@@ -195,7 +195,7 @@ block *substitute_internal(block *curr_block) {
     }
     return increment_debruijn(replacement);
   }
-  if (layout_int) {
+  if (layout_int && layout_int != ROPE_LAYOUT) {
     layout *layout_data = get_layout_data(layout_int);
     bool dirty = false;
     block *new_block = curr_block;
@@ -306,7 +306,7 @@ block *increment_debruijn(block *curr_block) {
   }
   uint64_t const hdr = curr_block->h.hdr;
   uint16_t layout_int = layout_hdr(hdr);
-  if (layout_int) {
+  if (layout_int && layout_int != ROPE_LAYOUT) {
     layout *layout_data = get_layout_data(layout_int);
     bool dirty = false;
     block *new_block = curr_block;
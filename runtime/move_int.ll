@@ -5,6 +5,12 @@ target triple = "@BACKEND_TARGET_TRIPLE@"
 
 ; helper function for int hooks
 define %mpz* @move_int(%mpz* %val) {
+  %small = call %mpz* @small_int(%mpz* %val)
+  %is_small = icmp ne %mpz* %small, null
+  br i1 %is_small, label %shared, label %boxed
+shared:
+  ret %mpz* %small
+boxed:
   %loaded = load %mpz, %mpz* %val
   %malloccall = tail call i8* @kore_alloc_integer(i64 0)
   %ptr = bitcast i8* %malloccall to %mpz*
@@ -12,5 +18,5 @@ define %mpz* @move_int(%mpz* %val) {
   ret %mpz* %ptr
 }
 
+declare %mpz* @small_int(%mpz*)
 declare noalias i8* @kore_alloc_integer(i64)
-
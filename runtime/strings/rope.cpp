@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "runtime/alloc.h"
+#include "runtime/header.h"
+
+namespace {
+
+// Concatenations shorter than this are copied eagerly; the extra indirection
+// of a rope node does not pay off for short strings.
+constexpr uint64_t rope_min_length = 256;
+
+// A short flat string appended to a rope whose rightmost leaf is flat is
+// merged into that leaf as long as the merged leaf stays below this size.
+// This keeps ropes built by repeated small appends from degenerating into one
+// node per append.
+constexpr uint64_t rope_max_leaf_length = 512;
+
+uint64_t rope_depth(string *s) {
+  return is_rope(s) ? reinterpret_cast<rope *>(s)->depth : 0;
+}
+
+// A rope that has already been flattened is equivalent to its flat contents.
+string *strip_flattened_rope(string *s) {
+  if (is_rope(s)) {
+    auto *node = reinterpret_cast<rope *>(s);
+    if (node->depth == 0) {
+      return node->left;
+    }
+  }
+  return s;
+}
+
+string *make_rope(string *left, string *right) {
+  auto *node = static_cast<rope *>(kore_alloc(sizeof(rope)));
+  node->h.hdr = ROPE_TAG | ((sizeof(rope) / 8) << 32)
+                | ((uint64_t)ROPE_LAYOUT << LAYOUT_OFFSET);
+  node->left = left;
+  node->right = right;
+  node->length = rope_length(left) + rope_length(right);
+  node->depth = std::max(rope_depth(left), rope_depth(right)) + 1;
+  return reinterpret_cast<string *>(node);
+}
+
+// Copies the contents of a flat string or rope to dest, which must have room
+// for rope_length(s) bytes.
+void write_flat(string *s, char *dest) {
+  std::vector<string *> stack = {s};
+  while (!stack.empty()) {
+    string *curr = strip_flattened_rope(stack.back());
+    stack.pop_back();
+    if (is_rope(curr)) {
+      auto *node = reinterpret_cast<rope *>(curr);
+      stack.push_back(node->right);
+      stack.push_back(node->left);
+    } else {
+      memcpy(dest, curr->data, len(curr));
+      dest += len(curr);
+    }
+  }
+}
+
+string *concat_flat(string *a, string *b) {
+  uint64_t len_a = rope_length(a);
+  uint64_t len_b = rope_length(b);
+  auto *ret = static_cast<string *>(
+      kore_alloc_token(sizeof(string) + len_a + len_b));
+  init_with_len(ret, len_a + len_b);
+  write_flat(a, ret->data);
+  write_flat(b, ret->data + len_a);
+  return ret;
+}
+
+// The children of a rope that has not been flattened.
+string *rope_left(string *s) {
+  return strip_flattened_rope(reinterpret_cast<rope *>(s)->left);
+}
+
+string *rope_right(string *s) {
+  return strip_flattened_rope(reinterpret_cast<rope *>(s)->right);
+}
+
+// ((x, y), z) -> (x, (y, z))
+string *rotate_right(string *s) {
+  string *left = rope_left(s);
+  return make_rope(
+      rope_left(left), make_rope(rope_right(left), rope_right(s)));
+}
+
+// (x, (y, z)) -> ((x, y), z)
+string *rotate_left(string *s) {
+  string *right = rope_right(s);
+  return make_rope(
+      make_rope(rope_left(s), rope_left(right)), rope_right(right));
+}
+
+// Builds the rope (left, right), where the depths of left and right differ by
+// at most two, restoring the invariant that the depths of the children of a
+// rope differ by at most one.
+string *make_balanced_rope(string *left, string *right) {
+  uint64_t depth_left = rope_depth(left);
+  uint64_t depth_right = rope_depth(right);
+  if (depth_right > depth_left + 1) {
+    if (rope_depth(rope_left(right)) > rope_depth(rope_right(right))) {
+      right = rotate_right(right);
+    }
+    return rotate_left(make_rope(left, right));
+  }
+  if (depth_left > depth_right + 1) {
+    if (rope_depth(rope_right(left)) > rope_depth(rope_left(left))) {
+      left = rotate_left(left);
+    }
+    return rotate_right(make_rope(left, right));
+  }
+  return make_rope(left, right);
+}
+
+// Concatenates two balanced ropes as in the join operation on AVL trees: the
+// shallower rope is inserted along the spine of the deeper one, so only the
+// O(log n) nodes on that path are rebuilt.
+string *join(string *a, string *b) {
+  uint64_t depth_a = rope_depth(a);
+  uint64_t depth_b = rope_depth(b);
+  if (depth_a > depth_b + 1) {
+    return make_balanced_rope(rope_left(a), join(rope_right(a), b));
+  }
+  if (depth_b > depth_a + 1) {
+    return make_balanced_rope(join(a, rope_left(b)), rope_right(b));
+  }
+  return make_rope(a, b);
+}
+
+// Merges the flat string b into the rightmost leaf of a, rebuilding the right
+// spine of a. Returns nullptr if the merged leaf would be too long.
+string *append_to_last_leaf(string *a, string *b) {
+  if (!is_rope(a)) {
+    return len(a) + len(b) <= rope_max_leaf_length ? concat_flat(a, b)
+                                                   : nullptr;
+  }
+  string *right = append_to_last_leaf(rope_right(a), b);
+  return right ? make_rope(rope_left(a), right) : nullptr;
+}
+
+} // namespace
+
+extern "C" {
+
+uint64_t rope_length(string *s) {
+  return is_rope(s) ? reinterpret_cast<rope *>(s)->length : len(s);
+}
+
+string *flatten_string(string *s) {
+  if (!is_rope(s)) {
+    return s;
+  }
+  auto *node = reinterpret_cast<rope *>(s);
+  if (node->depth == 0) {
+    return node->left;
+  }
+  // The flattened string is cached in the rope, so it must not be younger
+  // than the rope itself: an old object pointing into the young generation
+  // would not be traced by a minor collection.
+  bool old = node->h.hdr & (NOT_YOUNG_OBJECT_BIT | AGE_MASK);
+  size_t size = sizeof(string) + node->length;
+  auto *result = static_cast<string *>(
+      old ? kore_alloc_token_old(size) : kore_alloc_token(size));
+  init_with_len(result, node->length);
+  if (old) {
+    result->h.hdr |= NOT_YOUNG_OBJECT_BIT | AGE_MASK;
+  }
+  write_flat(s, result->data);
+  node->left = result;
+  node->right = result;
+  node->depth = 0;
+  return result;
+}
+
+string *rope_concat(string *a, string *b) {
+  a = strip_flattened_rope(a);
+  b = strip_flattened_rope(b);
+  uint64_t len_a = rope_length(a);
+  uint64_t len_b = rope_length(b);
+  if (len_a + len_b < rope_min_length) {
+    return concat_flat(a, b);
+  }
+  if (is_rope(a) && !is_rope(b) && len_b < rope_max_leaf_length) {
+    if (string *merged = append_to_last_leaf(a, b)) {
+      return merged;
+    }
+  }
+  return join(a, b);
+}
+}
@@ -20,8 +20,6 @@ extern "C" {
 floating *move_float(floating *);
 
 string *bytes2string(string *, size_t);
-string *hook_BYTES_concat(string *a, string *b);
-mpz_ptr hook_BYTES_length(string *a);
 string *hook_BYTES_substr(string *a, mpz_t start, mpz_t end);
 char *get_terminated_string(string *str);
 
@@ -62,11 +60,13 @@ bool hook_STRING_ne(SortString a, SortString b) {
 }
 
 SortString hook_STRING_concat(SortString a, SortString b) {
-  return hook_BYTES_concat(a, b);
+  return rope_concat(a, b);
 }
 
 SortInt hook_STRING_length(SortString a) {
-  return hook_BYTES_length(a);
+  mpz_t result;
+  mpz_init_set_ui(result, rope_length(a));
+  return move_int(result);
 }
 
 static inline uint64_t gs(mpz_t i) {
@@ -272,6 +272,7 @@ SortString hook_STRING_token2string(string *input) {
   if (is_injection(in_block)) {
     input = (string *)strip_injection(in_block);
   }
+  input = flatten_string(input);
 
   if (get_layout(input) != 0) {
     KLLVM_HOOK_INVALID_ARGUMENT(
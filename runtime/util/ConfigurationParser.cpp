@@ -57,6 +57,25 @@ static uint32_t get_tag_for_symbol(kore_symbol const &symbol) {
   return get_tag_for_symbol_name(name.c_str());
 }
 
+// An injection applied to another injection is represented by the inner
+// injection alone. first_child points to the slot holding the first child.
+static bool is_nested_injection(uint64_t hdr, void *const *first_child) {
+  uint32_t tag = tag_hdr(hdr);
+  if (tag < FIRST_INJ_TAG || tag > LAST_INJ_TAG) {
+    return false;
+  }
+  layout *data = get_layout_data(layout_hdr(hdr));
+  if (data->args[0].cat != SYMBOL_LAYOUT) {
+    return false;
+  }
+  auto *child = (block *)*first_child;
+  if (is_leaf_block(child) || get_layout(child) == 0) {
+    return false;
+  }
+  uint32_t child_tag = tag_hdr(child->h.hdr);
+  return child_tag >= FIRST_INJ_TAG && child_tag <= LAST_INJ_TAG;
+}
+
 void *
 construct_composite_pattern(uint32_t tag, std::vector<void *> &arguments) {
   if (is_symbol_a_function(tag)) {
@@ -66,18 +85,8 @@ construct_composite_pattern(uint32_t tag, std::vector<void *> &arguments) {
   struct blockheader header_val = get_block_header_for_symbol(tag);
   size_t size = size_hdr(header_val.hdr);
 
-  if (tag >= FIRST_INJ_TAG && tag <= LAST_INJ_TAG) {
-    uint16_t layout_code = layout_hdr(header_val.hdr);
-    layout *data = get_layout_data(layout_code);
-    if (data->args[0].cat == SYMBOL_LAYOUT) {
-      auto *child = (block *)arguments[0];
-      if (!is_leaf_block(child) && get_layout(child) != 0) {
-        uint32_t tag = tag_hdr(child->h.hdr);
-        if (tag >= FIRST_INJ_TAG && tag <= LAST_INJ_TAG) {
-          return child;
-        }
-      }
-    }
+  if (is_nested_injection(header_val.hdr, arguments.data())) {
+    return arguments[0];
   }
 
   auto *new_block = (block *)kore_alloc(size);
@@ -91,6 +100,21 @@ construct_composite_pattern(uint32_t tag, std::vector<void *> &arguments) {
   return new_block;
 }
 
+block *finish_composite_block(block *term) {
+  if (is_leaf_block(term)) {
+    return term;
+  }
+  layout *data = get_layout_data(layout_hdr(term->h.hdr));
+  auto **first_child = (void **)((char *)term + data->args[0].offset);
+  if (is_nested_injection(term->h.hdr, first_child)) {
+    return (block *)*first_child;
+  }
+  if (is_symbol_a_binder(tag_hdr(term->h.hdr))) {
+    return debruijnize(term);
+  }
+  return term;
+}
+
 struct construction {
   uint32_t tag;
   size_t nchildren;
@@ -161,6 +185,54 @@ extern "C" void *construct_initial_configuration(kore_pattern const *initial) {
   return output[0];
 }
 
+namespace {
+
+// Builds a configuration on the heap directly from the events reported by
+// kore_parser::pattern(pattern_handler &), following the same construction
+// rules as construct_initial_configuration.
+class configuration_builder : public pattern_handler {
+public:
+  void string(std::string const &contents) override {
+    token_stack_.push_back(contents);
+  }
+
+  void application(std::string const &symbol, size_t arity) override {
+    if (symbol.starts_with("\\dv{")) {
+      auto sort = symbol.substr(4, symbol.find('{', 4) - 4);
+      auto const &token = token_stack_.back();
+      output_.push_back(get_token(sort.c_str(), token.size(), token.c_str()));
+      token_stack_.pop_back();
+      return;
+    }
+
+    uint32_t tag = get_tag_for_symbol_name(symbol.c_str());
+
+    if (is_symbol_a_function(tag) && arity == 0) {
+      output_.push_back(evaluate_function_symbol(tag, nullptr));
+      return;
+    }
+    if (arity == 0) {
+      output_.push_back(leaf_block(tag));
+      return;
+    }
+
+    auto arguments = std::vector<void *>(output_.end() - arity, output_.end());
+    output_.resize(output_.size() - arity);
+    output_.push_back(construct_composite_pattern(tag, arguments));
+  }
+
+  void *result() {
+    assert(output_.size() == 1 && "Output stack left in invalid state");
+    return output_.front();
+  }
+
+private:
+  std::vector<std::string> token_stack_;
+  std::vector<void *> output_;
+};
+
+} // namespace
+
 // NOLINTBEGIN(*-cognitive-complexity)
 template <typename It>
 static void *
@@ -267,14 +339,14 @@ block *parse_configuration(char const *filename) {
     auto data = file_contents(filename);
     return deserialize_configuration(data.data(), data.size());
   }
-  auto initial_configuration = parser::kore_parser(filename).pattern();
-  // InitialConfiguration->print(std::cout);
-
-  // Allocate the llvm KORE datastructures for the configuration
-  auto *b
-      = (block *)construct_initial_configuration(initial_configuration.get());
-  deallocate_s_ptr_kore_pattern(std::move(initial_configuration));
-  return b;
+
+  // Allocate the llvm KORE datastructures for the configuration as it is
+  // parsed, without building an AST for it first
+  gc_enabled = false;
+  configuration_builder builder;
+  parser::kore_parser(filename).pattern(builder);
+  gc_enabled = true;
+  return static_cast<block *>(builder.result());
 }
 
 block *deserialize_configuration(char *data, size_t size) {
@@ -108,6 +108,9 @@ void print_configuration_internal(
     sfprintf(file, "%s()", symbol);
     return;
   }
+  if (is_rope(subject)) {
+    subject = (block *)flatten_string((string *)subject);
+  }
   uint16_t layout = get_layout(subject);
   if (!layout) {
     auto *str = (string *)subject;
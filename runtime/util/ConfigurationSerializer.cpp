@@ -7,11 +7,16 @@
 
 #include <fmt/printf.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <set>
+#include <thread>
 
 using namespace kllvm;
 using namespace kllvm::parser;
@@ -48,8 +53,204 @@ struct serialization_state {
   std::unordered_map<string *, std::string, string_hash, string_eq> var_names;
   std::set<std::string> used_var_names;
   uint64_t var_counter{0};
+
+  // Set when a bound variable has been named; the names chosen depend on
+  // every variable named before, so a chunk serialized on a worker thread
+  // that names one must be serialized again in order.
+  bool named_variable{false};
 };
 
+namespace {
+
+// Large configurations can be serialized on several threads by setting
+// KLLVM_SERIALIZE_THREADS. Collections with at least
+// KLLVM_SERIALIZE_MIN_ELEMENTS elements are then split into one contiguous
+// range of elements per thread, each serialized into its own buffer; the
+// buffers are written out in order, so the output is byte-identical to that
+// of a sequential serialization. Only the thread that started serializing
+// splits collections.
+size_t env_or(char const *name, size_t default_value) {
+  char const *value = getenv(name);
+  return value ? std::max(1L, atol(value)) : default_value;
+}
+
+size_t serialization_threads() {
+  static size_t threads = env_or("KLLVM_SERIALIZE_THREADS", 1);
+  return threads;
+}
+
+size_t parallel_min_elements() {
+  static size_t min = env_or("KLLVM_SERIALIZE_MIN_ELEMENTS", 4096);
+  return min;
+}
+
+thread_local bool may_split = false;
+
+// Allows collections to be split for the duration of a top-level call into
+// the serializer.
+class parallel_scope {
+public:
+  parallel_scope()
+      : previous_(may_split) {
+    may_split = serialization_threads() > 1;
+  }
+  ~parallel_scope() { may_split = previous_; }
+
+  parallel_scope(parallel_scope const &) = delete;
+  parallel_scope &operator=(parallel_scope const &) = delete;
+
+private:
+  bool previous_;
+};
+
+// Printing Ints, Floats and MInts and flattening ropes allocate on the K heap,
+// whose allocator is not thread-safe. While worker threads are running, those
+// calls (and the symbol sort cache) are serialized through shared_mutex.
+bool workers_running = false;
+std::mutex shared_mutex;
+
+template <typename F>
+auto exclusively(F const &f) {
+  if (!workers_running) {
+    return f();
+  }
+  std::lock_guard<std::mutex> guard(shared_mutex);
+  return f();
+}
+
+bool should_split(size_t size) {
+  return may_split && size >= parallel_min_elements();
+}
+
+// Calls serialize(chunk, begin, end) for one contiguous range of the count
+// elements of a collection per chunk, each on its own thread.
+template <typename Chunk, typename Serialize>
+void serialize_chunks(
+    std::vector<Chunk> &chunks, size_t count, Serialize const &serialize) {
+  size_t n = chunks.size();
+  std::vector<std::exception_ptr> errors(n);
+  auto run = [&](size_t i) {
+    try {
+      serialize(chunks[i], count * i / n, count * (i + 1) / n);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  may_split = false;
+  workers_running = true;
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < n; ++i) {
+    workers.emplace_back(run, i);
+  }
+  run(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers_running = false;
+  may_split = true;
+
+  for (auto const &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+// Chunks serialized in the binary KORE format use no string interning, so
+// that they do not depend on what has been serialized before them. They are
+// replayed into the main serializer, which interns their strings exactly as
+// if they had been emitted there in the first place.
+void replay_chunk(serializer &instance, std::string const &chunk) {
+  auto version = serializer::version;
+  auto const *ptr = chunk.data();
+  auto const *end = ptr + chunk.size();
+  while (ptr < end) {
+    char header = *ptr++;
+    instance.emit(header);
+    switch (header) {
+    case header_byte<kore_composite_pattern>:
+      instance.emit_length(detail::read_length(ptr, end, version, 2));
+      break;
+    case header_byte<kore_symbol>:
+    case header_byte<kore_composite_sort>:
+      instance.emit_length(detail::read_length(ptr, end, version, 2));
+      instance.emit_string(detail::read_string(ptr, end, version));
+      break;
+    case header_byte<kore_string_pattern>:
+    case header_byte<kore_sort_variable>:
+      instance.emit_string(detail::read_string(ptr, end, version));
+      break;
+    default: throw std::runtime_error("Internal serialization exception");
+    }
+  }
+}
+
+// Serializes count collection elements on several threads with
+// serialize(state, begin, end), then emits them to the state that the
+// collection is being serialized to.
+template <typename Serialize>
+void serialize_in_parallel(
+    serialization_state &state, size_t count, Serialize const &serialize) {
+  std::vector<serialization_state> chunks;
+  chunks.reserve(serialization_threads());
+  for (size_t i = 0; i < serialization_threads(); ++i) {
+    chunks.emplace_back(serializer::flags(
+        serializer::flags::DropHeader | serializer::flags::NoIntern));
+    chunks.back().bound_variables = state.bound_variables;
+  }
+
+  serialize_chunks(
+      chunks, count,
+      [&](serialization_state &chunk, size_t begin, size_t end) {
+        serialize(chunk, begin, end);
+      });
+
+  size_t n = chunks.size();
+  for (size_t i = 0; i < n; ++i) {
+    if (chunks[i].named_variable) {
+      serialize(state, count * i / n, count * (i + 1) / n);
+    } else {
+      replay_chunk(state.instance, chunks[i].instance.data());
+    }
+  }
+}
+
+// Chunks serialized in the KORE term format on worker threads are written to
+// a buffer rather than to the writer.
+thread_local std::string *chunk_buffer = nullptr;
+
+void write_v2(writer *file, void const *ptr, size_t size) {
+  if (chunk_buffer) {
+    chunk_buffer->append(static_cast<char const *>(ptr), size);
+  } else {
+    sfwrite(ptr, 1, size, file);
+  }
+}
+
+template <typename Serialize>
+void serialize_in_parallel_v2(
+    writer *file, size_t count, Serialize const &serialize) {
+  std::vector<std::string> chunks(serialization_threads());
+
+  serialize_chunks(chunks, count, [&](std::string &chunk, size_t b, size_t e) {
+    chunk_buffer = &chunk;
+    try {
+      serialize(b, e);
+    } catch (...) {
+      chunk_buffer = nullptr;
+      throw;
+    }
+    chunk_buffer = nullptr;
+  });
+
+  for (auto const &chunk : chunks) {
+    sfwrite(chunk.data(), 1, chunk.size(), file);
+  }
+}
+
+} // namespace
+
 static std::string drop_back(std::string const &s, int n) {
   return s.substr(0, s.size() - n);
 }
@@ -79,8 +280,8 @@ const uint8_t STRING = 0x00;
 const uint8_t NULL_BYTE = 0x00;
 
 static void emit_symbol_v2(writer *file, int32_t tag) {
-  sfwrite(&COMPOSITE, sizeof(COMPOSITE), 1, file);
-  sfwrite(&tag, sizeof(tag), 1, file);
+  write_v2(file, &COMPOSITE, sizeof(COMPOSITE));
+  write_v2(file, &tag, sizeof(tag));
 }
 
 /**
@@ -122,10 +323,10 @@ static void emit_token(
 static void
 emit_token_v2(writer *file, uint32_t sort, char const *str, size_t len) {
   emit_symbol_v2(file, sort);
-  sfwrite(&STRING, sizeof(STRING), 1, file);
-  sfwrite(&len, sizeof(len), 1, file);
-  sfwrite(str, 1, len, file);
-  sfwrite(&NULL_BYTE, sizeof(NULL_BYTE), 1, file);
+  write_v2(file, &STRING, sizeof(STRING));
+  write_v2(file, &len, sizeof(len));
+  write_v2(file, str, len);
+  write_v2(file, &NULL_BYTE, sizeof(NULL_BYTE));
 }
 
 void serialize_map(
@@ -142,6 +343,27 @@ void serialize_map(
   auto tag = get_tag_for_symbol_name(element);
   auto *arg_sorts = get_argument_sorts_for_tag(tag);
 
+  if (should_split(size)) {
+    auto elements = std::vector<std::pair<block *, block *>>(
+        map->begin(), map->end());
+    serialize_in_parallel(
+        *static_cast<serialization_state *>(state), size,
+        [&](serialization_state &chunk, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            serialize_configuration_internal(
+                file, elements[i].first, arg_sorts[0], false, &chunk);
+            serialize_configuration_internal(
+                file, elements[i].second, arg_sorts[1], false, &chunk);
+            emit_symbol(chunk.instance, element, 2);
+
+            if (i != 0) {
+              emit_symbol(chunk.instance, concat, 2);
+            }
+          }
+        });
+    return;
+  }
+
   for (auto iter = map->begin(); iter != map->end(); ++iter) {
     serialize_configuration_internal(
         file, iter->first, arg_sorts[0], false, state);
@@ -169,6 +391,21 @@ void serialize_map_v2(
     emit_symbol_v2(file, concat);
   }
 
+  if (should_split(size)) {
+    auto elements = std::vector<std::pair<block *, block *>>(
+        map->begin(), map->end());
+    serialize_in_parallel_v2(file, size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        emit_symbol_v2(file, element);
+        serialize_configuration_v2_internal(
+            file, elements[i].first, arg_sorts[0], false);
+        serialize_configuration_v2_internal(
+            file, elements[i].second, arg_sorts[1], false);
+      }
+    });
+    return;
+  }
+
   for (auto iter = map->begin(); iter != map->end(); ++iter) {
     emit_symbol_v2(file, element);
     serialize_configuration_v2_internal(file, iter->first, arg_sorts[0], false);
@@ -256,6 +493,24 @@ void serialize_list(
   auto tag = get_tag_for_symbol_name(element);
   auto *arg_sorts = get_argument_sorts_for_tag(tag);
 
+  if (should_split(size)) {
+    auto elements = std::vector<block *>(list->begin(), list->end());
+    serialize_in_parallel(
+        *static_cast<serialization_state *>(state), size,
+        [&](serialization_state &chunk, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            serialize_configuration_internal(
+                file, elements[i], arg_sorts[0], false, &chunk);
+            emit_symbol(chunk.instance, element, 1);
+
+            if (i != 0) {
+              emit_symbol(chunk.instance, concat, 2);
+            }
+          }
+        });
+    return;
+  }
+
   for (auto iter = list->begin(); iter != list->end(); ++iter) {
     serialize_configuration_internal(file, *iter, arg_sorts[0], false, state);
     emit_symbol(instance, element, 1);
@@ -281,6 +536,18 @@ void serialize_list_v2(
     emit_symbol_v2(file, concat);
   }
 
+  if (should_split(size)) {
+    auto elements = std::vector<block *>(list->begin(), list->end());
+    serialize_in_parallel_v2(file, size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        emit_symbol_v2(file, element);
+        serialize_configuration_v2_internal(
+            file, elements[i], arg_sorts[0], false);
+      }
+    });
+    return;
+  }
+
   for (auto iter = list->begin(); iter != list->end(); ++iter) {
     emit_symbol_v2(file, element);
     serialize_configuration_v2_internal(file, *iter, arg_sorts[0], false);
@@ -301,6 +568,24 @@ void serialize_set(
   auto tag = get_tag_for_symbol_name(element);
   auto *arg_sorts = get_argument_sorts_for_tag(tag);
 
+  if (should_split(size)) {
+    auto elements = std::vector<block *>(set->begin(), set->end());
+    serialize_in_parallel(
+        *static_cast<serialization_state *>(state), size,
+        [&](serialization_state &chunk, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            serialize_configuration_internal(
+                file, elements[i], arg_sorts[0], false, &chunk);
+            emit_symbol(chunk.instance, element, 1);
+
+            if (i != 0) {
+              emit_symbol(chunk.instance, concat, 2);
+            }
+          }
+        });
+    return;
+  }
+
   for (auto iter = set->begin(); iter != set->end(); ++iter) {
     serialize_configuration_internal(file, *iter, arg_sorts[0], false, state);
     emit_symbol(instance, element, 1);
@@ -325,6 +610,18 @@ void serialize_set_v2(
     emit_symbol_v2(file, concat);
   }
 
+  if (should_split(size)) {
+    auto elements = std::vector<block *>(set->begin(), set->end());
+    serialize_in_parallel_v2(file, size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        emit_symbol_v2(file, element);
+        serialize_configuration_v2_internal(
+            file, elements[i], arg_sorts[0], false);
+      }
+    });
+    return;
+  }
+
   for (auto iter = set->begin(); iter != set->end(); ++iter) {
     emit_symbol_v2(file, element);
     serialize_configuration_v2_internal(file, *iter, arg_sorts[0], false);
@@ -334,24 +631,24 @@ void serialize_set_v2(
 void serialize_int(writer *file, mpz_t i, char const *sort, void *state) {
   auto &instance = static_cast<serialization_state *>(state)->instance;
 
-  auto str = int_to_string(i);
+  auto str = exclusively([&] { return int_to_string(i); });
   emit_token(instance, sort, str.c_str());
 }
 
 void serialize_int_v2(writer *file, mpz_t i, uint32_t sort) {
-  auto str = int_to_string(i);
+  auto str = exclusively([&] { return int_to_string(i); });
   emit_token_v2(file, sort, str.data(), str.length());
 }
 
 void serialize_float(writer *file, floating *f, char const *sort, void *state) {
   auto &instance = static_cast<serialization_state *>(state)->instance;
 
-  std::string str = float_to_string(f);
+  auto str = exclusively([&] { return float_to_string(f); });
   emit_token(instance, sort, str.c_str());
 }
 
 void serialize_float_v2(writer *file, floating *f, uint32_t sort) {
-  auto str = float_to_string(f);
+  auto str = exclusively([&] { return float_to_string(f); });
   emit_token_v2(file, sort, str.data(), str.length());
 }
 
@@ -382,16 +679,20 @@ void serialize_m_int(
     writer *file, size_t *i, size_t bits, char const *sort, void *state) {
   auto &instance = static_cast<serialization_state *>(state)->instance;
 
-  auto str = (i == nullptr) ? std::string("0")
-                            : int_to_string(hook_MINT_import(i, bits, false));
+  auto str = exclusively([&] {
+    return (i == nullptr) ? std::string("0")
+                          : int_to_string(hook_MINT_import(i, bits, false));
+  });
 
   auto buffer = fmt::format("{}p{}", str, bits);
   emit_token(instance, sort, buffer.c_str());
 }
 
 void serialize_m_int_v2(writer *file, size_t *i, size_t bits, uint32_t sort) {
-  auto str = (i == nullptr) ? std::string("0")
-                            : int_to_string(hook_MINT_import(i, bits, false));
+  auto str = exclusively([&] {
+    return (i == nullptr) ? std::string("0")
+                          : int_to_string(hook_MINT_import(i, bits, false));
+  });
 
   auto buffer = fmt::format("{}p{}", str, bits);
   emit_token_v2(file, sort, buffer.data(), buffer.length());
@@ -404,6 +705,11 @@ cached_symbol_sort_list(std::string const &symbol) {
   static auto cache = std::unordered_map<
       std::string, std::pair<std::string, std::vector<sptr<kore_sort>>>>{};
 
+  std::unique_lock<std::mutex> lock(shared_mutex, std::defer_lock);
+  if (workers_running) {
+    lock.lock();
+  }
+
   if (cache.find(symbol) == cache.end()) {
     auto [id, sorts] = kore_parser::from_string(symbol)->symbol_sort_list();
 
@@ -442,11 +748,19 @@ void serialize_configuration_internal(
     return;
   }
 
+  if (is_rope(subject)) {
+    subject = exclusively(
+        [&] { return (block *)flatten_string((string *)subject); });
+  }
   uint16_t layout = get_layout(subject);
   if (!layout) {
     auto *str = (string *)subject;
     size_t subject_len = len(subject);
 
+    if (is_var) {
+      state.named_variable = true;
+    }
+
     if (is_var && !state.var_names.contains(str)) {
       std::string std_str = std::string(str->data, len(str));
       std::string suffix;
@@ -536,6 +850,10 @@ void serialize_configuration_v2_internal(
     return;
   }
 
+  if (is_rope(subject)) {
+    subject = exclusively(
+        [&] { return (block *)flatten_string((string *)subject); });
+  }
   uint16_t layout = get_layout(subject);
   if (!layout) {
     auto *str = (string *)subject;
@@ -564,6 +882,7 @@ void serialize_configuration_v2_internal(
 void serialize_configurations(
     FILE *file, std::unordered_set<block *, hash_block, k_eq> results) {
   auto state = serialization_state();
+  auto scope = parallel_scope();
 
   auto w = writer{file, nullptr};
   auto size = results.size();
@@ -609,16 +928,32 @@ void serialize_configuration_to_file_v2(FILE *file, block *subject) {
 void serialize_configuration_v2(FILE *file, block *subject, uint32_t sort) {
   fputs("\x7FKR2", file);
   writer w = {file, nullptr};
+  auto scope = parallel_scope();
   serialize_configuration_v2_internal(&w, subject, sort, false);
 }
 
 void serialize_configuration(
     block *subject, char const *sort, char **data_out, size_t *size_out,
     bool emit_size, bool use_intern) {
+  *data_out = nullptr;
+  *size_out = serialize_configuration_with_allocator(
+      subject, sort, emit_size, use_intern,
+      [](size_t size, void *context) {
+        auto *buf = static_cast<char *>(malloc(size));
+        *static_cast<char **>(context) = buf;
+        return buf;
+      },
+      data_out);
+}
+
+size_t serialize_configuration_with_allocator(
+    block *subject, char const *sort, bool emit_size, bool use_intern,
+    char *(*allocate)(size_t size, void *context), void *context) {
   auto state = serialization_state(
       use_intern ? serializer::flags::NONE : serializer::flags::NoIntern);
 
   writer w = {nullptr, nullptr};
+  auto scope = parallel_scope();
   serialize_configuration_internal(&w, subject, sort, false, &state);
 
   if (emit_size) {
@@ -626,11 +961,11 @@ void serialize_configuration(
   }
 
   auto size = state.instance.data().size();
-  auto *buf = static_cast<char *>(malloc(size));
-  std::copy_n(state.instance.data().begin(), size, buf);
+  if (auto *buf = allocate(size, context)) {
+    std::copy_n(state.instance.data().begin(), size, buf);
+  }
 
-  *data_out = buf;
-  *size_out = size;
+  return size;
 }
 
 void write_uint64_to_file(FILE *file, uint64_t i) {
@@ -668,6 +1003,7 @@ void serialize_term_to_file_v2(
   store_symbol_children(term, &arg);
   fputs("\x7FKR2", file);
   writer w = {file, nullptr};
+  auto scope = parallel_scope();
 
   serialize_visitor callbacks
       = {serialize_configuration_v2_internal,
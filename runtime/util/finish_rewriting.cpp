@@ -10,6 +10,7 @@ FILE *output_file = nullptr;
 bool statistics = false;
 bool binary_output = false;
 bool proof_output = false;
+uint64_t proof_hint_mask = ~uint64_t{0};
 
 extern int64_t steps;
 extern bool safe_partial;
@@ -1,6 +1,7 @@
 #include <cstdint>
 #include <cstring>
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "runtime/collect.h"
@@ -22,6 +23,12 @@ static block *state;
 static std::unordered_set<block *, hash_block, k_eq> states_set;
 static std::unordered_set<block *, hash_block, k_eq> results;
 
+// When successors are memoized, the successors of every state expanded so far.
+// The successors of a state depend only on the state, so a state that is
+// reached again is not matched and rewritten a second time.
+static std::unordered_map<block *, std::vector<block *>, hash_block, k_eq>
+    successors;
+
 static std::pair<
     std::vector<block **>::iterator, std::vector<block **>::iterator>
 block_enumerator() {
@@ -46,13 +53,21 @@ block_enumerator() {
     blocks.push_back(const_cast<block **>(&(key_val)));
   }
 
+  for (auto &key_val : successors) {
+    blocks.push_back(const_cast<block **>(&(key_val.first)));
+    for (auto &successor : key_val.second) {
+      blocks.push_back(&successor);
+    }
+  }
+
   return std::make_pair(blocks.begin(), blocks.end());
   // NOLINTEND(*-const-cast)
 }
 
 // NOLINTNEXTLINE(*-cognitive-complexity)
 std::unordered_set<block *, hash_block, k_eq> take_search_steps(
-    bool execute_to_branch, int64_t depth, int64_t bound, block *subject) {
+    bool execute_to_branch, int64_t depth, int64_t bound,
+    bool memoize_successors, block *subject) {
   static int registered = -1;
   if (registered == -1) {
     register_gc_roots_enumerator(block_enumerator);
@@ -61,6 +76,7 @@ std::unordered_set<block *, hash_block, k_eq> take_search_steps(
   states.clear();
   states_set.clear();
   results.clear();
+  successors.clear();
 
   if (bound == 0) {
     return results;
@@ -79,7 +95,14 @@ std::unordered_set<block *, hash_block, k_eq> take_search_steps(
     }
 
     step_results.clear();
-    take_search_step(state);
+    if (!memoize_successors) {
+      take_search_step(state);
+    } else if (auto iter = successors.find(state); iter != successors.end()) {
+      step_results = iter->second;
+    } else {
+      take_search_step(state);
+      successors.emplace(state, step_results);
+    }
 
     if (execute_to_branch && step_results.size() > 1) {
       results.insert(state);
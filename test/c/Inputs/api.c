@@ -50,6 +50,12 @@ struct kllvm_c_api load_c_api(char const *path) {
   API_FUNCTION(kore_simplify);
   API_FUNCTION(kore_simplify_binary);
   API_FUNCTION(take_steps);
+  API_FUNCTION(kore_symbol_tag);
+  API_FUNCTION(kore_symbol_arity);
+  API_FUNCTION(kore_block_new);
+  API_FUNCTION(kore_block_set_child);
+  API_FUNCTION(kore_block_finish);
+  API_FUNCTION(kore_token_new);
   API_FUNCTION(kore_sort_dump);
   API_FUNCTION(kore_sort_free);
   API_FUNCTION(kore_sort_is_concrete);
@@ -39,6 +39,12 @@ struct kllvm_c_api {
   void (*kore_simplify_binary)(
       kore_error *, char *, size_t, kore_sort const *, char **, size_t *);
   block *(*take_steps)(int64_t depth, block *term);
+  uint32_t (*kore_symbol_tag)(kore_error *, char const *);
+  uint32_t (*kore_symbol_arity)(uint32_t);
+  block *(*kore_block_new)(uint32_t);
+  void (*kore_block_set_child)(block *, uint32_t, void *);
+  block *(*kore_block_finish)(block *);
+  void *(*kore_token_new)(char const *, char const *, size_t);
   char *(*kore_sort_dump)(kore_sort const *);
   void (*kore_sort_free)(kore_sort const *);
   bool (*kore_sort_is_concrete)(kore_sort const *);
@@ -0,0 +1,60 @@
+#include "api.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+block *make_int(struct kllvm_c_api *api, uint32_t inj, char const *value) {
+  block *term = api->kore_block_new(inj);
+  api->kore_block_set_child(
+      term, 0, api->kore_token_new("SortInt", value, strlen(value)));
+  return api->kore_block_finish(term);
+}
+
+int main(int argc, char **argv) {
+  if (argc <= 1) {
+    return 1;
+  }
+
+  struct kllvm_c_api api = load_c_api(argv[1]);
+
+  api.kllvm_init();
+
+  uint32_t plus = api.kore_symbol_tag(
+      NULL,
+      "Lbl'UndsPlusUndsUnds'ARITHMETIC-SYNTAX'Unds'Exp'Unds'Exp'Unds'Exp{}");
+  uint32_t inj = api.kore_symbol_tag(NULL, "inj{SortInt{}, SortExp{}}");
+  uint32_t inj_kitem
+      = api.kore_symbol_tag(NULL, "inj{SortExp{}, SortKItem{}}");
+  assert(api.kore_symbol_arity(plus) == 2);
+  assert(api.kore_symbol_arity(inj) == 1);
+
+  kore_error *err = api.kore_error_new();
+  api.kore_symbol_tag(err, "Lblundefined{}");
+  assert(!api.kore_error_is_success(err));
+
+  block *sum = api.kore_block_new(plus);
+  api.kore_block_set_child(sum, 0, make_int(&api, inj, "75"));
+  api.kore_block_set_child(sum, 1, make_int(&api, inj, "12"));
+  sum = api.kore_block_finish(sum);
+
+  // An injection of an injection is represented by the inner injection...
+  block *operand = make_int(&api, inj, "75");
+  block *nested = api.kore_block_new(inj_kitem);
+  api.kore_block_set_child(nested, 0, operand);
+  assert(api.kore_block_finish(nested) == operand);
+
+  // ...but an injection of any other term is kept.
+  block *wrapped = api.kore_block_new(inj_kitem);
+  api.kore_block_set_child(wrapped, 0, sum);
+  assert(api.kore_block_finish(wrapped) == wrapped);
+
+  kore_pattern *pat = api.kore_pattern_from_block(sum);
+  kore_sort *sort_exp = api.kore_composite_sort_new("SortExp");
+  kore_pattern *input = api.kore_pattern_make_interpreter_input(pat, sort_exp);
+
+  block *term = api.kore_pattern_construct(input);
+  block *after = api.take_steps(-1, term);
+
+  printf("%s", api.kore_block_dump(after));
+}
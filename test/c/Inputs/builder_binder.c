@@ -0,0 +1,83 @@
+#include "api.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct symbols {
+  uint32_t lambda;
+  uint32_t inj_var;
+  uint32_t inj_val;
+};
+
+block *make_unary(struct kllvm_c_api *api, uint32_t tag, void *child) {
+  block *term = api->kore_block_new(tag);
+  api->kore_block_set_child(term, 0, child);
+  return api->kore_block_finish(term);
+}
+
+block *make_binary(
+    struct kllvm_c_api *api, uint32_t tag, void *first, void *second) {
+  block *term = api->kore_block_new(tag);
+  api->kore_block_set_child(term, 0, first);
+  api->kore_block_set_child(term, 1, second);
+  return api->kore_block_finish(term);
+}
+
+void *make_var(struct kllvm_c_api *api, char const *name) {
+  return api->kore_token_new("SortKVar", name, strlen(name));
+}
+
+// Builds the identity function on the variable with the given name, as a term
+// of sort Exp.
+block *
+make_identity(struct kllvm_c_api *api, struct symbols *s, char const *name) {
+  block *body = make_unary(api, s->inj_var, make_var(api, name));
+  block *lambda = make_binary(api, s->lambda, make_var(api, name), body);
+  return make_unary(api, s->inj_val, lambda);
+}
+
+int main(int argc, char **argv) {
+  if (argc <= 1) {
+    return 1;
+  }
+
+  struct kllvm_c_api api = load_c_api(argv[1]);
+
+  api.kllvm_init();
+
+  struct symbols s = {
+      api.kore_symbol_tag(
+          NULL,
+          "Lbllambda'UndsStopUndsUnds'LAMBDA-SYNTAX'Unds'Val'Unds'KVar'Unds'"
+          "Exp{}"),
+      api.kore_symbol_tag(NULL, "inj{SortKVar{}, SortExp{}}"),
+      api.kore_symbol_tag(NULL, "inj{SortVal{}, SortExp{}}"),
+  };
+  uint32_t app = api.kore_symbol_tag(
+      NULL, "Lbl'UndsUndsUnds'LAMBDA-SYNTAX'Unds'Exp'Unds'Exp'Unds'Exp{}");
+
+  // (lambda x . x) (lambda y . y) only steps to lambda y . y if the bound
+  // occurrence of x was replaced by its index when the binder was finished;
+  // otherwise the substitution leaves the body x unchanged.
+  block *pgm = make_binary(
+      &api, app, make_identity(&api, &s, "x"), make_identity(&api, &s, "y"));
+
+  // The configuration is built directly as well, so that the program does
+  // not go through the pattern-based construction.
+  block *k = make_binary(
+      &api, api.kore_symbol_tag(NULL, "kseq{}"),
+      make_unary(
+          &api, api.kore_symbol_tag(NULL, "inj{SortExp{}, SortKItem{}}"), pgm),
+      api.kore_block_new(api.kore_symbol_tag(NULL, "dotk{}")));
+  block *top = make_binary(
+      &api, api.kore_symbol_tag(NULL, "Lbl'-LT-'generatedTop'-GT-'{}"),
+      make_unary(&api, api.kore_symbol_tag(NULL, "Lbl'-LT-'k'-GT-'{}"), k),
+      make_unary(
+          &api,
+          api.kore_symbol_tag(NULL, "Lbl'-LT-'generatedCounter'-GT-'{}"),
+          api.kore_token_new("SortInt", "0", 1)));
+
+  block *after = api.take_steps(-1, top);
+
+  printf("%s", api.kore_block_dump(after));
+}
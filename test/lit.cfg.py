@@ -99,6 +99,7 @@ config.substitutions.extend([
         fi
     ''')),
     ('%search-interpreter', '%kompile %s search -o %t.interpreter'),
+    ('%codegen', '%kompile %s ir'),
     ('%convert-input', '%kore-convert %test-input -o %t.bin'),
     ('%strip-binary', 'kore-strip'),
     ('%arity', 'kore-arity'),
@@ -166,6 +167,12 @@ config.substitutions.extend([
             echo "kore-proof-trace error while parsing proof hint trace with expanded kore terms and streaming parser"
             exit 1
         fi
+        %kore-proof-trace --lazy --verbose --expand-terms %t.header.bin %t.out.bin | diff - %test-proof-diff-out -q
+        result="$?"
+        if [ "$result" -ne 0 ]; then
+            echo "kore-proof-trace error while parsing proof hint trace with expanded kore terms and lazy decoding"
+            exit 1
+        fi
     ''')),
 
     ('%check-dir-proof-out', one_line('''
@@ -34,6 +34,13 @@ class TestTermConstruct(unittest.TestCase):
             back = kllvm.runtime.Term.deserialize(binary)
             self.assertEqual(str(term), str(back))
 
+            out = bytearray(b'garbage')
+            self.assertEqual(term.serialize_into(out, emit_size=es), len(binary))
+            self.assertEqual(out, binary)
+            for view in [out, memoryview(binary)]:
+                back = kllvm.runtime.Term.deserialize(view)
+                self.assertEqual(str(term), str(back))
+
     def test_construct(self):
         """
         syntax Foo ::= one() | two() | three()
@@ -100,6 +100,51 @@ class TestParser(unittest.TestCase):
 
         self.assertEqual(it.get_next_event(), None)
 
+    def test_lazy_visitor(self):
+        binary_proof_trace = os.path.join(
+            os.path.dirname(os.path.realpath(__file__)),
+            "Output", "test_proof_trace.py.tmp", "proof_trace.bin")
+        binary_header_path = os.path.join(
+            os.path.dirname(os.path.realpath(__file__)),
+            "Output", "test_proof_trace.py.tmp", "header.bin")
+        header = kllvm.prooftrace.kore_header(binary_header_path)
+
+        with open(binary_proof_trace, 'rb') as f:
+            eager = kllvm.prooftrace.llvm_rewrite_trace.parse(f.read(), header)
+
+        class Collector(kllvm.prooftrace.llvm_rewrite_trace_visitor):
+            def __init__(self):
+                super().__init__()
+                self.configs = []
+                self.rules = []
+
+            def config(self, type, config):
+                self.configs.append((type, config))
+
+            def rule(self, type, event):
+                self.rules.append(event.rule_ordinal)
+
+        visitor = Collector()
+        it = kllvm.prooftrace.llvm_rewrite_trace_iterator.from_file(
+            binary_proof_trace, header, lazy=True)
+        it.visit(visitor)
+
+        # the initial and final configurations are only decoded on request
+        self.assertEqual(len(visitor.configs), 2)
+        initial_type, initial = visitor.configs[0]
+        self.assertEqual(initial_type, kllvm.prooftrace.EventType.InitialConfig)
+        self.assertFalse(initial.is_decoded)
+        self.assertEqual(repr(initial.pattern),
+                         repr(eager.initial_config.kore_pattern))
+        self.assertTrue(initial.is_decoded)
+        self.assertEqual(repr(visitor.configs[1][1].pattern),
+                         repr(eager.trace[2].kore_pattern))
+
+        self.assertEqual(
+            visitor.rules,
+            [eager.trace[0].step_event.rule_ordinal,
+             eager.trace[1].step_event.rule_ordinal])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,67 @@
+# RUN: mkdir -p %t
+# RUN: export KORE_DEF=$(realpath Inputs/proof-trace.kore)
+# RUN: export IN=$(realpath Inputs/proof-trace.in)
+# RUN: cd %t && %kompile "$KORE_DEF" main --proof-hint-instrumentation -o interpreter
+# RUN: rm -f proof_trace.bin && ./interpreter "$IN" -1 proof_trace.bin --proof-output
+# RUN: rm -f elided_trace.bin && ./interpreter "$IN" -1 elided_trace.bin --proof-output --proof-hint-mask 0
+# RUN: kore-rich-header "$KORE_DEF" > %t/header.bin
+
+
+# RUN: %python %s
+
+from test_bindings import kllvm
+
+import os
+import unittest
+
+
+class TestParser(unittest.TestCase):
+    def output_path(self, name):
+        return os.path.join(
+            os.path.dirname(os.path.realpath(__file__)),
+            "Output", "test_proof_trace_elided.py.tmp", name)
+
+    def parse(self, name, header):
+        with open(self.output_path(name), 'rb') as f:
+            trace = kllvm.prooftrace.llvm_rewrite_trace.parse(f.read(), header)
+            self.assertFalse(trace is None)
+            return trace
+
+    def test_elided_rules(self):
+        header = kllvm.prooftrace.kore_header(self.output_path("header.bin"))
+        full = self.parse("proof_trace.bin", header)
+        elided = self.parse("elided_trace.bin", header)
+
+        # with every kind of event masked out, each rewrite step is recorded
+        # as a rule_elided event carrying only the ordinal of the rule
+        self.assertEqual(len(elided.trace), len(full.trace))
+        for full_event, elided_event in zip(full.trace, elided.trace):
+            self.assertEqual(
+                full_event.is_step_event(), elided_event.is_step_event())
+            if not full_event.is_step_event():
+                continue
+            step = elided_event.step_event
+            self.assertIsInstance(
+                step, kllvm.prooftrace.llvm_elided_rule_event)
+            self.assertEqual(
+                step.rule_ordinal, full_event.step_event.rule_ordinal)
+
+        it = kllvm.prooftrace.llvm_rewrite_trace_iterator.from_file(
+            self.output_path("elided_trace.bin"), header)
+        ordinals = []
+        while True:
+            event = it.get_next_event()
+            if event is None:
+                break
+            if event.type == kllvm.prooftrace.EventType.Trace \
+                    and event.event.is_step_event():
+                ordinals.append(event.event.step_event.rule_ordinal)
+
+        self.assertEqual(
+            ordinals,
+            [e.step_event.rule_ordinal for e in full.trace
+             if e.is_step_event()])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -32,6 +32,10 @@ cl::opt<bool> use_streaming_parser(
     llvm::cl::desc("Use streaming event parser to parse trace"),
     llvm::cl::cat(kore_proof_trace_cat));
 
+cl::opt<bool> lazy_terms(
+    "lazy", llvm::cl::desc("Only decode KORE terms when they are printed"),
+    llvm::cl::cat(kore_proof_trace_cat));
+
 int main(int argc, char **argv) {
   cl::HideUnrelatedOptions({&kore_proof_trace_cat});
   cl::ParseCommandLineOptions(argc, argv);
@@ -43,14 +47,16 @@ int main(int argc, char **argv) {
   if (use_streaming_parser) {
     std::ifstream file(input_filename, std::ios_base::binary);
     llvm_rewrite_trace_iterator it(
-        std::make_unique<proof_trace_file_buffer>(std::move(file)), header);
+        std::make_unique<proof_trace_file_buffer>(std::move(file)), header,
+        lazy_terms);
     if (verbose_output) {
       it.print(std::cout, expand_terms_in_output);
     }
     return 0;
   }
 
-  proof_trace_parser parser(verbose_output, expand_terms_in_output, header);
+  proof_trace_parser parser(
+      verbose_output, expand_terms_in_output, header, lazy_terms);
   auto trace = parser.parse_proof_trace_from_file(input_filename);
   if (trace.has_value()) {
     return 0;
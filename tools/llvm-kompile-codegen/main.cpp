@@ -161,8 +161,8 @@ int main(int argc, char **argv) {
   llvm::LLVMContext context;
   std::unique_ptr<llvm::Module> mod = new_module("definition", context);
 
-  if (debug) {
-    init_debug_info(mod.get(), definition_path);
+  if (debug || debug_line_tables_only) {
+    init_debug_info(mod.get(), definition_path, !debug);
   }
 
   emit_metadata(*mod);
@@ -232,7 +232,7 @@ int main(int argc, char **argv) {
     }
   }
 
-  if (debug) {
+  if (debug || debug_line_tables_only) {
     finalize_debug_info();
   }
 
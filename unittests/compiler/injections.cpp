@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+#include <kllvm/ast/AST.h>
+
+using namespace kllvm;
+
+namespace {
+
+sptr<kore_composite_pattern> attribute(std::string const &name) {
+  return kore_composite_pattern::create(name);
+}
+
+void add_symbol(
+    sptr<kore_module> const &mod, std::string const &name, bool function,
+    bool hooked = false) {
+  sptr<kore_symbol_declaration> decl
+      = kore_symbol_declaration::create(name, hooked);
+  if (function) {
+    decl->attributes().add(attribute("function"));
+  }
+  mod->add_declaration(decl);
+}
+
+sptr<kore_pattern>
+app(std::string const &name, std::vector<sptr<kore_pattern>> const &args) {
+  sptr<kore_composite_pattern> pat = kore_composite_pattern::create(name);
+  for (auto const &arg : args) {
+    pat->add_argument(arg);
+  }
+  return pat;
+}
+
+// \implies(\top(), \equals(f(), \and(rhs, \top())))
+void add_rule(
+    sptr<kore_module> const &mod, std::string const &function,
+    sptr<kore_pattern> const &rhs) {
+  sptr<kore_axiom_declaration> decl = kore_axiom_declaration::create();
+  auto body = app("\\and", {rhs, app("\\top", {})});
+  decl->add_pattern(app(
+      "\\implies",
+      {app("\\top", {}), app("\\equals", {app(function, {}), body})}));
+  mod->add_declaration(decl);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(InjectionAnalysisTest)
+
+BOOST_AUTO_TEST_CASE(may_return_injection) {
+  auto sub = kore_composite_sort::create("SortSub");
+  auto super = kore_composite_sort::create("SortSuper");
+
+  auto mod = sptr<kore_module>(kore_module::create("FooModule"));
+
+  auto subsort = attribute("subsort");
+  subsort->get_constructor()->add_formal_argument(sub);
+  subsort->get_constructor()->add_formal_argument(super);
+  sptr<kore_axiom_declaration> subsort_decl = kore_axiom_declaration::create();
+  subsort_decl->attributes().add(subsort);
+  mod->add_declaration(subsort_decl);
+
+  sptr<kore_symbol_declaration> inj = kore_symbol_declaration::create("inj");
+  inj->attributes().add(attribute("sortInjection"));
+  mod->add_declaration(inj);
+
+  add_symbol(mod, "c", false);
+  for (auto const *name :
+       {"ctor", "call", "var", "leaf", "injects", "cycle1", "cycle2",
+        "undefined"}) {
+    add_symbol(mod, name, true);
+  }
+  add_symbol(mod, "hooked", true, true);
+
+  add_rule(mod, "ctor", app("c", {}));
+  add_rule(mod, "call", app("ctor", {}));
+  add_rule(mod, "var", kore_variable_pattern::create("X", super));
+  add_rule(mod, "leaf", kore_variable_pattern::create("Y", sub));
+  add_rule(mod, "injects", app("inj", {app("c", {})}));
+  add_rule(mod, "cycle1", app("cycle2", {}));
+  add_rule(mod, "cycle2", app("cycle1", {}));
+  add_rule(mod, "hooked", app("c", {}));
+
+  auto def = kore_definition::create();
+  def->add_module(mod);
+
+  BOOST_CHECK(!def->may_return_injection("ctor"));
+  BOOST_CHECK(!def->may_return_injection("call"));
+  BOOST_CHECK(def->may_return_injection("var"));
+  BOOST_CHECK(!def->may_return_injection("leaf"));
+  BOOST_CHECK(def->may_return_injection("injects"));
+  BOOST_CHECK(!def->may_return_injection("cycle1"));
+  BOOST_CHECK(!def->may_return_injection("cycle2"));
+  BOOST_CHECK(def->may_return_injection("undefined"));
+  BOOST_CHECK(def->may_return_injection("hooked"));
+  BOOST_CHECK(def->may_return_injection("c"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+#include <boost/test/unit_test.hpp>
+
+#include "kllvm/parser/KOREParser.h"
+
+#include <sstream>
+
+using namespace kllvm;
+using namespace kllvm::parser;
+
+namespace {
+
+// Rebuilds the text of each reported pattern in the same format as print
+// below.
+class printer : public pattern_handler {
+public:
+  void string(std::string const &contents) override {
+    output.push_back("\"" + contents + "\"");
+  }
+
+  void application(std::string const &symbol, size_t arity) override {
+    std::string text = symbol + "(";
+    for (size_t i = output.size() - arity; i < output.size(); ++i) {
+      text += output[i] + (i + 1 < output.size() ? "," : "");
+    }
+    output.resize(output.size() - arity);
+    output.push_back(text + ")");
+  }
+
+  std::vector<std::string> output;
+};
+
+void print(std::ostream &out, kore_pattern *pat) {
+  if (auto *str = dynamic_cast<kore_string_pattern *>(pat)) {
+    out << "\"" << str->get_contents() << "\"";
+    return;
+  }
+  auto *comp = dynamic_cast<kore_composite_pattern *>(pat);
+  out << ast_to_string(*comp->get_constructor()) << "(";
+  for (size_t i = 0; i < comp->get_arguments().size(); ++i) {
+    out << (i ? "," : "");
+    print(out, comp->get_arguments()[i].get());
+  }
+  out << ")";
+}
+
+std::string parse_with_handler(std::string const &text) {
+  printer handler;
+  kore_parser::from_string(text)->pattern(handler);
+  BOOST_REQUIRE_EQUAL(handler.output.size(), 1);
+  return handler.output[0];
+}
+
+std::string parse_to_ast(std::string const &text) {
+  std::ostringstream out;
+  print(out, kore_parser::from_string(text)->pattern().get());
+  return out.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ParserTest)
+
+BOOST_AUTO_TEST_CASE(handler_matches_ast) {
+  for (auto const *text :
+       {R"("foo")", R"(c{}())",
+        R"(Lbl'-LT-'k'-GT-'{}(kseq{}(inj{SortInt{}, SortKItem{}}()"
+        R"(\dv{SortInt{}}("12")),dotk{}())))",
+        R"(f{SortList{S,T{}}}(g{}(), "a", h{S}("b")))",
+        R"(\left-assoc{}(f{}("a","b","c","d")))",
+        R"(\right-assoc{}(f{}("a","b","c","d")))",
+        R"(c{}(\left-assoc{}(f{}("a")), \right-assoc{}(g{}("b"))))"}) {
+    BOOST_CHECK_EQUAL(parse_with_handler(text), parse_to_ast(text));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(deep_nesting) {
+  // Counts the applications reported, checking that each has the single
+  // argument reported before it.
+  class counter : public pattern_handler {
+  public:
+    void string(std::string const &contents) override { pending++; }
+
+    void application(std::string const &symbol, size_t arity) override {
+      BOOST_REQUIRE_EQUAL(pending, arity);
+      pending = 1;
+      applications++;
+    }
+
+    size_t pending = 0;
+    size_t applications = 0;
+  };
+
+  size_t depth = 1000000;
+  std::string text;
+  for (size_t i = 0; i < depth; ++i) {
+    text += "f{}(";
+  }
+  text += "a{}()" + std::string(depth, ')');
+
+  counter handler;
+  kore_parser::from_string(text)->pattern(handler);
+  BOOST_CHECK_EQUAL(handler.applications, depth + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,3 +1,4 @@
+#include <array>
 #include <boost/test/unit_test.hpp>
 #include <gmp.h>
 
@@ -58,6 +59,61 @@ void *kore_alloc_always_gc(size_t size) {
 }
 }
 
+namespace {
+
+// Reference implementations of 256-bit arithmetic on the words written by
+// int_low_words, mirroring the code emitted for Int expressions reduced
+// modulo 2^256.
+using words = std::array<uint64_t, 4>;
+
+words to_words(mpz_t i) {
+  words result;
+  int_low_words(i, result.data(), result.size());
+  return result;
+}
+
+words add_words(words const &a, words const &b) {
+  words result;
+  unsigned __int128 carry = 0;
+  for (size_t i = 0; i < result.size(); ++i) {
+    carry += (unsigned __int128)a[i] + b[i];
+    result[i] = (uint64_t)carry;
+    carry >>= 64;
+  }
+  return result;
+}
+
+words mul_words(words const &a, words const &b) {
+  words result{};
+  for (size_t i = 0; i < result.size(); ++i) {
+    unsigned __int128 carry = 0;
+    for (size_t j = 0; i + j < result.size(); ++j) {
+      carry += (unsigned __int128)a[i] * b[j] + result[i + j];
+      result[i + j] = (uint64_t)carry;
+      carry >>= 64;
+    }
+  }
+  return result;
+}
+
+words xor_words(words const &a, words const &b) {
+  words result;
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = a[i] ^ b[i];
+  }
+  return result;
+}
+
+words neg_words(words const &a) {
+  words result;
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = ~a[i];
+  }
+  return add_words(result, {1, 0, 0, 0});
+}
+
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(IntTest)
 
 BOOST_AUTO_TEST_CASE(tmod) {
@@ -648,6 +704,99 @@ BOOST_AUTO_TEST_CASE(signExtendBitRange) {
   mpz_clear(len);
 }
 
+BOOST_AUTO_TEST_CASE(low_words) {
+  mpz_t i;
+  mpz_init_set_si(i, -1);
+  BOOST_CHECK(
+      to_words(i) == words({UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX}));
+  mpz_set_si(i, -2);
+  mpz_mul_2exp(i, i, 64);
+  BOOST_CHECK(
+      to_words(i) == words({0, UINT64_MAX - 1, UINT64_MAX, UINT64_MAX}));
+  mpz_set_ui(i, 1);
+  mpz_mul_2exp(i, i, 300);
+  mpz_add_ui(i, i, 5);
+  BOOST_CHECK(to_words(i) == words({5, 0, 0, 0}));
+  mpz_clear(i);
+}
+
+// Checks that 256-bit arithmetic on the words of two Ints, imported back with
+// hook_MINT_import, agrees with the corresponding GMP hooks.
+BOOST_AUTO_TEST_CASE(fixed_width) {
+  gmp_randstate_t state;
+  gmp_randinit_default(state);
+  gmp_randseed_ui(state, 42);
+
+  mpz_t a, b, pow256, off, len;
+  mpz_inits(a, b, pow256, nullptr);
+  mpz_ui_pow_ui(pow256, 2, 256);
+  mpz_init_set_ui(off, 0);
+  mpz_init_set_ui(len, 256);
+
+  auto check = [](mpz_ptr expected, words w, bool is_signed) {
+    mpz_ptr actual = hook_MINT_import(w.data(), 256, is_signed);
+    BOOST_CHECK_EQUAL(mpz_cmp(expected, actual), 0);
+    mpz_clear(expected);
+    free(expected);
+    mpz_clear(actual);
+    free(actual);
+  };
+
+  for (unsigned iter = 0; iter < 1000; ++iter) {
+    mpz_urandomb(a, state, 1 + iter % 400);
+    mpz_urandomb(b, state, 1 + (iter * 7) % 400);
+    if (iter % 2) {
+      mpz_neg(a, a);
+    }
+    if (iter % 3 == 0) {
+      mpz_neg(b, b);
+    }
+    words wa = to_words(a);
+    words wb = to_words(b);
+
+    mpz_ptr sum = hook_INT_add(a, b);
+    check(hook_INT_emod(sum, pow256), add_words(wa, wb), false);
+    mpz_ptr product = hook_INT_mul(a, b);
+    check(hook_INT_emod(product, pow256), mul_words(wa, wb), false);
+    mpz_ptr bits = hook_INT_xor(a, b);
+    check(hook_INT_bitRange(bits, off, len), xor_words(wa, wb), false);
+    mpz_ptr difference = hook_INT_sub(a, b);
+    check(
+        hook_INT_signExtendBitRange(difference, off, len),
+        add_words(wa, neg_words(wb)), true);
+
+    for (mpz_ptr i : {sum, product, bits, difference}) {
+      mpz_clear(i);
+      free(i);
+    }
+  }
+
+  mpz_clears(a, b, pow256, off, len, nullptr);
+  gmp_randclear(state);
+}
+
+BOOST_AUTO_TEST_CASE(small_int) {
+  mpz_t i;
+  for (long value : {-256L, -1L, 0L, 1L, 42L, 1024L}) {
+    mpz_init_set_si(i, value);
+    mpz_ptr shared = ::small_int(i);
+    BOOST_REQUIRE(shared);
+    BOOST_CHECK_EQUAL(mpz_cmp_si(shared, value), 0);
+    mpz_hdr *hdr = STRUCT_BASE(mpz_hdr, i, shared);
+    BOOST_CHECK(!is_heap_block(hdr));
+
+    mpz_init_set_si(i, value);
+    BOOST_CHECK(::small_int(i) == shared);
+  }
+
+  for (long value : {-257L, 1025L}) {
+    mpz_init_set_si(i, value);
+    BOOST_CHECK(!::small_int(i));
+    BOOST_CHECK_EQUAL(mpz_cmp_si(i, value), 0);
+    mpz_clear(i);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(rand) {
   mpz_t seed;
   mpz_init_set_ui(seed, 1);
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include "runtime/header.h"
+
+#include <cstddef>
+#include <cstdlib>
+
+// This test links hook_KEQUAL_eq from the collections library, but none of the
+// hooks it calls on the children of a term. Those are defined below so that
+// the test can see whether a comparison looked at the children at all.
+
+namespace {
+
+struct float_term {
+  blockheader h;
+  floating *child;
+};
+
+struct list_term {
+  blockheader h;
+  list child;
+};
+
+unsigned layout_lookups = 0;
+unsigned float_comparisons = 0;
+
+layoutitem float_term_args[] = {{offsetof(float_term, child), FLOAT_LAYOUT}};
+layoutitem list_term_args[] = {{offsetof(list_term, child), LIST_LAYOUT}};
+
+uint16_t const float_term_layout = 1;
+uint16_t const list_term_layout = 2;
+
+layout layouts[] = {{1, float_term_args}, {1, list_term_args}};
+
+blockheader header(uint16_t layout, uint32_t tag) {
+  return {((uint64_t)layout << LAYOUT_OFFSET) | tag};
+}
+
+void reset_counts() {
+  layout_lookups = 0;
+  float_comparisons = 0;
+}
+
+} // namespace
+
+extern "C" {
+
+bool during_gc() {
+  return false;
+}
+
+void *kore_alloc_token(size_t requested) {
+  return malloc(requested);
+}
+
+layout *get_layout_data(uint16_t layout) {
+  ++layout_lookups;
+  return &layouts[layout - 1];
+}
+
+// Every float child compares unequal, as NaN does, so two distinct terms with
+// a float child are never equal.
+bool hook_FLOAT_trueeq(floating *, floating *) {
+  ++float_comparisons;
+  return false;
+}
+
+bool hook_LIST_eq(list *l1, list *l2) {
+  return *l1 == *l2;
+}
+
+bool hook_MAP_eq(map *, map *) {
+  abort();
+}
+
+bool hook_RANGEMAP_eq(rangemap *, rangemap *) {
+  abort();
+}
+
+bool hook_SET_eq(set *, set *) {
+  abort();
+}
+
+bool hook_INT_eq(mpz_ptr, mpz_ptr) {
+  abort();
+}
+
+bool hook_STRING_eq(string *, string *) {
+  abort();
+}
+
+bool hook_STRING_lt(string *, string *) {
+  abort();
+}
+
+string *flatten_string(string *) {
+  abort();
+}
+}
+
+bool gc_enabled;
+
+BOOST_AUTO_TEST_SUITE(KEqualTest)
+
+BOOST_AUTO_TEST_CASE(identical_term) {
+  reset_counts();
+  float_term term = {header(float_term_layout, 1), nullptr};
+  auto *elem = reinterpret_cast<block *>(&term);
+
+  BOOST_CHECK(hook_KEQUAL_eq(elem, elem));
+  BOOST_CHECK_EQUAL(layout_lookups, 0);
+  BOOST_CHECK_EQUAL(float_comparisons, 0);
+
+  float_term copy = term;
+  BOOST_CHECK(!hook_KEQUAL_eq(elem, reinterpret_cast<block *>(&copy)));
+  BOOST_CHECK_EQUAL(layout_lookups, 1);
+  BOOST_CHECK_EQUAL(float_comparisons, 1);
+}
+
+BOOST_AUTO_TEST_CASE(collection_of_identical_term) {
+  reset_counts();
+  float_term term = {header(float_term_layout, 1), nullptr};
+  float_term copy = term;
+  auto *elem = reinterpret_cast<block *>(&term);
+
+  // Two lists built separately share no nodes, so their elements are
+  // compared one by one.
+  list_term l1 = {header(list_term_layout, 2), list{k_elem(elem)}};
+  list_term l2 = {header(list_term_layout, 2), list{k_elem(elem)}};
+  list_term l3 = {
+      header(list_term_layout, 2),
+      list{k_elem(reinterpret_cast<block *>(&copy))}};
+
+  BOOST_CHECK(hook_KEQUAL_eq(
+      reinterpret_cast<block *>(&l1), reinterpret_cast<block *>(&l2)));
+  BOOST_CHECK_EQUAL(layout_lookups, 1);
+  BOOST_CHECK_EQUAL(float_comparisons, 0);
+
+  BOOST_CHECK(!hook_KEQUAL_eq(
+      reinterpret_cast<block *>(&l1), reinterpret_cast<block *>(&l3)));
+  BOOST_CHECK_EQUAL(float_comparisons, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -113,6 +113,21 @@ BOOST_AUTO_TEST_CASE(keys) {
   BOOST_CHECK(hook_SET_in(DUMMY0, &set));
 }
 
+BOOST_AUTO_TEST_CASE(keys_many) {
+  static block items[1000];
+  auto map = hook_MAP_unit();
+  for (int i = 0; i < 1000; i++) {
+    items[i].h.hdr = i + 2;
+    map = hook_MAP_update(&map, &items[i], DUMMY0);
+  }
+  auto set = hook_MAP_keys(&map);
+  BOOST_CHECK_EQUAL(set.size(), 1000);
+  for (auto &item : items) {
+    BOOST_CHECK(hook_SET_in(&item, &set));
+  }
+  BOOST_CHECK(!hook_SET_in(DUMMY0, &set));
+}
+
 BOOST_AUTO_TEST_CASE(keys_list) {
   auto map = hook_MAP_element(DUMMY0, DUMMY0);
   auto list = hook_MAP_keys_list(&map);
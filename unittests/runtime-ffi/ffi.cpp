@@ -124,6 +124,10 @@ floating *move_float(floating *i) {
 
 block D1 = {{1}};
 block *DUMMY1 = &D1;
+block D2 = {{2}};
+block *DUMMY2 = &D2;
+block D3 = {{3}};
+block *DUMMY3 = &D3;
 }
 
 struct ffi_test_fixture {
@@ -556,6 +560,44 @@ BOOST_AUTO_TEST_CASE(allocated) {
   BOOST_CHECK_EQUAL(false, hook_FFI_allocated(i2));
 }
 
+BOOST_AUTO_TEST_CASE(leaf_key) {
+  mpz_t s1, s2;
+  mpz_init_set_ui(s1, 1);
+  mpz_init_set_ui(s2, 16);
+
+  block *leaf = leaf_block(42);
+  string *b1 = hook_FFI_alloc(leaf, s1, s2);
+  BOOST_CHECK_EQUAL(b1, hook_FFI_alloc(leaf, s1, s2));
+  BOOST_CHECK_EQUAL(true, hook_FFI_allocated(leaf));
+  BOOST_CHECK_EQUAL(leaf, hook_FFI_bytes_ref(b1));
+
+  hook_FFI_free(leaf);
+  BOOST_CHECK_EQUAL(false, hook_FFI_allocated(leaf));
+}
+
+BOOST_AUTO_TEST_CASE(free_keeps_others) {
+  mpz_t s1, s2;
+  mpz_init_set_ui(s1, 1);
+  mpz_init_set_ui(s2, 16);
+
+  hook_FFI_alloc(DUMMY1, s1, s2);
+  string *b2 = hook_FFI_alloc(DUMMY2, s1, s2);
+  string *b3 = hook_FFI_alloc(DUMMY3, s1, s2);
+
+  hook_FFI_free(DUMMY1);
+  BOOST_CHECK_EQUAL(false, hook_FFI_allocated(DUMMY1));
+  BOOST_CHECK_EQUAL(DUMMY2, hook_FFI_bytes_ref(b2));
+  BOOST_CHECK_EQUAL(DUMMY3, hook_FFI_bytes_ref(b3));
+
+  hook_FFI_free(DUMMY3);
+  BOOST_CHECK_EQUAL(true, hook_FFI_allocated(DUMMY2));
+  BOOST_CHECK_EQUAL(false, hook_FFI_allocated(DUMMY3));
+
+  // Freeing memory that was never allocated does nothing.
+  hook_FFI_free(DUMMY3);
+  BOOST_CHECK_EQUAL(b2, hook_FFI_alloc(DUMMY2, s1, s2));
+}
+
 BOOST_AUTO_TEST_CASE(alignment) {
   mpz_t s1, s2;
   mpz_init_set_ui(s1, 1);
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <string>
 
 #include <gmp.h>
 #include <mpfr.h>
@@ -239,6 +240,87 @@ BOOST_AUTO_TEST_CASE(concat) {
   BOOST_CHECK_EQUAL(len(catAll), len(expected));
 }
 
+BOOST_AUTO_TEST_CASE(rope_concat) {
+  auto chunk = std::string(100, 'a');
+  auto expected = std::string();
+  auto *str = make_string("");
+  for (int i = 0; i < 1000; ++i) {
+    chunk[0] = static_cast<char>('a' + i % 26);
+    str = hook_STRING_concat(str, make_string(chunk.c_str()));
+    expected += chunk;
+  }
+
+  BOOST_CHECK(is_rope(str));
+  BOOST_CHECK_EQUAL(rope_length(str), expected.size());
+  BOOST_CHECK_EQUAL(mpz_cmp_ui(hook_STRING_length(str), expected.size()), 0);
+
+  auto *flat = flatten_string(str);
+  BOOST_CHECK(!is_rope(flat));
+  BOOST_CHECK_EQUAL(len(flat), expected.size());
+  BOOST_CHECK_EQUAL(0, memcmp(flat->data, expected.data(), len(flat)));
+  BOOST_CHECK_EQUAL(flatten_string(str), flat);
+
+  auto *nested = hook_STRING_concat(str, str);
+  BOOST_CHECK_EQUAL(rope_length(nested), 2 * expected.size());
+  auto *nested_flat = flatten_string(nested);
+  BOOST_CHECK_EQUAL(
+      0, memcmp(nested_flat->data, expected.data(), expected.size()));
+  BOOST_CHECK_EQUAL(
+      0, memcmp(
+             nested_flat->data + expected.size(), expected.data(),
+             expected.size()));
+}
+
+BOOST_AUTO_TEST_CASE(rope_balanced) {
+  // Chunks too long to be merged into a leaf, so every append adds a node.
+  auto chunk = std::string(600, 'a');
+  auto expected = std::string();
+  auto *appended = make_string("");
+  auto *prepended = make_string("");
+  for (int i = 0; i < 4096; ++i) {
+    chunk[0] = static_cast<char>('a' + i % 26);
+    appended = hook_STRING_concat(appended, make_string(chunk.c_str()));
+    prepended = hook_STRING_concat(make_string(chunk.c_str()), prepended);
+    expected += chunk;
+  }
+
+  // A balanced tree over 4096 leaves is at most 1.44 * 12 deep.
+  BOOST_CHECK_LE(reinterpret_cast<rope *>(appended)->depth, 18);
+  BOOST_CHECK_LE(reinterpret_cast<rope *>(prepended)->depth, 18);
+
+  auto *flat = flatten_string(appended);
+  BOOST_CHECK_EQUAL(len(flat), expected.size());
+  BOOST_CHECK_EQUAL(0, memcmp(flat->data, expected.data(), len(flat)));
+
+  // Prepending reverses the order of the chunks.
+  auto *prepended_flat = flatten_string(prepended);
+  BOOST_CHECK_EQUAL(len(prepended_flat), expected.size());
+  for (int i = 0; i < 4096; ++i) {
+    BOOST_CHECK_EQUAL(
+        prepended_flat->data[(4095 - i) * chunk.size()],
+        static_cast<char>('a' + i % 26));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rope_small_appends) {
+  auto expected = std::string(300, 'x');
+  auto *str = make_string(expected.c_str());
+  for (int i = 0; i < 20000; ++i) {
+    auto suffix = std::to_string(i);
+    str = hook_STRING_concat(str, make_string(suffix.c_str()));
+    expected += suffix;
+  }
+
+  // Short appends are merged into leaves of up to 512 bytes.
+  BOOST_CHECK(is_rope(str));
+  BOOST_CHECK_LE(reinterpret_cast<rope *>(str)->depth, 20);
+  BOOST_CHECK_EQUAL(rope_length(str), expected.size());
+
+  auto *flat = flatten_string(str);
+  BOOST_CHECK_EQUAL(len(flat), expected.size());
+  BOOST_CHECK_EQUAL(0, memcmp(flat->data, expected.data(), len(flat)));
+}
+
 BOOST_AUTO_TEST_CASE(chr) {
   mpz_t a, b;
   mpz_init_set_ui(a, 65);